@@ -1,221 +1,1159 @@
-/***********************************************************************************
-  ControlPID.cpp
------------------------------------------------------------------------------------
-  Descripción:
-           Objeto de control PID. 
-           Limita efecto enrole mediante saturación y bloqueo de integración.
------------------------------------------------------------------------------------
-  Autor:   Guillermo Caporaletti <gfcaporaletti@undav.edu.ar>
-           Sistemas de Control Automático (SCA)
-           Universidad Nacional de Avellaneda (UNDAV)
-  Fecha:   Diciembre 2021
-  Version: 1.0
-***********************************************************************************/
-
-#include "Arduino.h"
-#include "ControlPID.h"
-
-/**************************************************************************************/
-
-controlPID::controlPID(float KP, float TI, float TD)                   
-// Constructor: incluye configuración inicial del PID y valores predeterminados.
-{  // Kp puede ser negativo (esto último podría servir para controlar una planta cuya salida 
-   //                        tienda a bajar cuando aumente la señal de control. Ej.: heladera.) 
-   // Si Ti=0, el PID no lo tomará en cuenta
-   // Si Td=0, el PID no lo tomará en cuenta
-   // Inicializa integración e impone false en límites y condicional.
-   ConfigurarPID(KP, TI, TD);
-   LimitaSalida=false;
-   LimitaIntegral=false;
-   CondicionaIntegral=false;
-}
-//-------------------------------------------------------------------------------------
-
-void controlPID::ConfigurarPID(float KP, float TI, float TD)
-// Configura las constantes básicas del control PID 
-// Sirve para cambiar configuración inicial, sin modificar límites y condicional.
-{  // Kp puede ser negativo (esto último podría servir para controlar una planta cuya salida 
-   //                        tienda a bajar cuando aumente la señal de control. Ej.: heladera.) 
-   // Si Ti=0, el PID no lo tomará en cuenta
-   // Si Td=0, el PID no lo tomará en cuenta
-   // Resetea valores de integración.
-   Kp=KP;
-   Ti=TI;
-   Td=TD;
-   TiempoAnterior=0;
-   ErrorAnterior=0;
-   Integral=0;
-   //LimitaSalida=false;
-   //LimitaIntegral=false;   
-   //CondicionaIntegral=false;
-}
-//-------------------------------------------------------------------------------------
-
-boolean controlPID::LimitarSalida()
-// Devuelve el valor de la variable privada LimitaSalida
-// que indica si nuestro PID está configurado para limitar su salida.
-{  return LimitaSalida;
-}
-//-------------------------------------------------------------------------------------
-
-boolean controlPID::LimitarSalida(boolean RESPUESTA)
-// Configura si limitará la salida...
-// No permite activar límites si antes no fueron establecidos.
-{  LimitaSalida=RESPUESTA;
-   if (SalidaMax==0 && SalidaMin==0) {
-     // ...no voy a limitar porque no tengo límites definidos.
-     LimitaSalida=false;
-   }
-   return LimitaSalida;
-}//-------------------------------------------------------------------------------------
-
-boolean controlPID::LimitarSalida(boolean RESPUESTA, float SMIN, float SMAX)
-// Configura si limitará la salida entre SMAX y SMIN.
-// Se puede establecer los límites pero no activarlos aún.
-// No activa con SMIN=SMAX.
-// No activa si SMIN>SMAX.
-{  SalidaMax=SMAX;
-   SalidaMin=SMIN;
-   LimitaSalida=RESPUESTA;
-   // La forma de desactivar este límite es:
-   // 1) Volviendo a llamar esta función con RESPUESTA=false
-   // 2) Llamando a LimitarSalida(false)
-   // También se pueden poner límites muy grandes.
-   if (SalidaMax==SalidaMin) {
-     // ...no voy a limitar porque no tengo límites definidos.
-     LimitaSalida=false;
-   }
-   if (SalidaMin>SalidaMax) {
-     // ...no voy a limitar porque están mal configurados.
-     LimitaSalida=false;
-   }
-   return LimitaSalida;
-}
-//-------------------------------------------------------------------------------------
-
-boolean controlPID::LimitarIntegral()
-// Devuelve el valor de la variable privada LimitaIntegral
-// que indica si nuestro PID está configurado para limitar la integral.
-{  return LimitaIntegral;
-}
-//-------------------------------------------------------------------------------------
-
-boolean controlPID::LimitarIntegral(boolean RESPUESTA)
-// Configura los límites al integrador entre los mismos márgenes de la salida.
-// Para establecer el límite, previamente se debe haber configurado los límites de salida.
-{  LimitaIntegral=RESPUESTA;  // Puede ser true o false
-   if (SalidaMax==SalidaMin) {
-     // ...no voy a limitar porque no tengo límites definidos.
-     LimitaIntegral=false;
-   }
-   return LimitaIntegral;
-}
-//-------------------------------------------------------------------------------------
-
-boolean controlPID::CondicionarIntegral()
-// Devuelve el valor de CondicionaIntegral.
-{  return CondicionaIntegral;
-}
-//-------------------------------------------------------------------------------------
-
-boolean controlPID::CondicionarIntegral(boolean RESPUESTA)
-// Establece si debo pausar la integración cuando la salida está saturada.
-// Deben haberse preestablecido los límites de salida.
-{  
-   CondicionaIntegral = RESPUESTA;
-   if (!LimitaSalida) CondicionaIntegral=false;
-   return CondicionaIntegral;
-}
-//-------------------------------------------------------------------------------------
-
-float controlPID::Controlar(float ERROR)
-// Calcula Salida en función de la señal error y los parámetros del PID
-{  unsigned long TiempoActual = micros(); // Tomo tiempo actual para comparar 
-                                          // con la medida anterior
-   boolean SalidaEstaSaturada = false;
-   
-   // PROPORCIONAL --------------------------------------------------------------
-   Proporcional = Kp*ERROR;
-
-   // DERIVATIVO ----------------------------------------------------------------
-   if (TiempoAnterior>0 && Td!=0) {  
-      // Dos condiciones para componente derivativa:
-      // 1) Que no sea el primer cálculo y 2) Td seteado
-      Derivativo = Kp*Td*(ERROR-ErrorAnterior)*MILLON / (TiempoActual-TiempoAnterior);
-   } else { 
-      Derivativo = 0;
-   }
-
-   // ¿Debo saturar salida? -----------------------------------------------------
-   Salida = Proporcional + Integral + Derivativo;
-   if (LimitaSalida && ((Salida > SalidaMax) || (Salida<SalidaMin))) {
-      // Debo saturar la salida...
-      SalidaEstaSaturada = true;
-   }
-   
-   // INTEGRAL ------------------------------------------------------------------
-   if (TiempoAnterior>0 && Ti!=0) {
-      // Cumplidas las dos primeras condiciones para integral el error:
-      
-      if (!CondicionaIntegral || !SalidaEstaSaturada) {
-        // Si no está configurada la condición o si no está salutarda la salida, 
-        // puedo hacer la integral:
-        Integral += Kp * (ERROR+ErrorAnterior) * (TiempoActual-TiempoAnterior) / (2*Ti*MILLON);
-      }
-
-      if (LimitaIntegral) {
-        // Debo saturar la integral:
-        Integral = min(Integral, SalidaMax);
-        Integral = max(Integral, SalidaMin);
-      }
-   }
-
-   // Termina componente integral ----------------------------------------------
-   
-   // Cáculo final completo: 
-   Salida = Proporcional + Integral + Derivativo;
-
-   if (LimitaSalida) {
-      // Debo saturar la salida:
-      Salida = min(Salida, SalidaMax);
-      Salida = max(Salida, SalidaMin);
-   }
-   TiempoAnterior = TiempoActual;
-   ErrorAnterior = ERROR;
-   return Salida;
-   // Termina funcion PID ------------------------------------------------------
-}
-//-------------------------------------------------------------------------------------
-
-float controlPID::ObtenerIntegral()
-{
-   return Integral; 
-}
-//-------------------------------------------------------------------------------------
-
-float controlPID::ObtenerProporcional()
-{
-   return Proporcional;
-}
-//-------------------------------------------------------------------------------------
-
-float controlPID::ObtenerDerivativo()
-{
-   return Derivativo;
-}
-//-------------------------------------------------------------------------------------
-
-float controlPID::ObtenerSalida()
-{
-   return Salida;
-}
-//-------------------------------------------------------------------------------------
-
-void controlPID::Apagar()
-{
-   TiempoAnterior=0;
-   ErrorAnterior=0;
-   Integral=0;   
-   Proporcional=0;
-   Derivativo=0; 
-}
+/***********************************************************************************
+  ControlPID.cpp
+-----------------------------------------------------------------------------------
+  Descripción:
+           Objeto de control PID. 
+           Limita efecto enrole mediante saturación y bloqueo de integración.
+-----------------------------------------------------------------------------------
+  Autor:   Guillermo Caporaletti <gfcaporaletti@undav.edu.ar>
+           Sistemas de Control Automático (SCA)
+           Universidad Nacional de Avellaneda (UNDAV)
+  Fecha:   Diciembre 2021
+  Version: 1.0
+***********************************************************************************/
+
+#include "Arduino.h"
+#include "ControlPID.h"
+#ifndef CONTROLPID_COMPACTO
+#include "ControlPIDTelemetria.h"
+#endif
+#include <stddef.h>
+
+/**************************************************************************************/
+
+uint16_t CrcPID(const void* DATOS, size_t BYTES, uint16_t CRC)
+// CRC-16/CCITT bit a bit: sin tabla, para no ocupar memoria de programa.
+{  const uint8_t* Byte = (const uint8_t*)DATOS;
+   while (BYTES--) {
+      CRC ^= (uint16_t)(*Byte++) << 8;
+      for (uint8_t i=0; i<8; i++) CRC = (CRC & 0x8000) ? (CRC << 1) ^ 0x1021 : (CRC << 1);
+   }
+   return CRC;
+}
+//-------------------------------------------------------------------------------------
+
+controlPID::controlPID(float KP, float TI, float TD)                   
+// Constructor: incluye configuración inicial del PID y valores predeterminados.
+{  // Kp puede ser negativo (esto último podría servir para controlar una planta cuya salida 
+   //                        tienda a bajar cuando aumente la señal de control. Ej.: heladera.) 
+   // Si Ti=0, el PID no lo tomará en cuenta
+   // Si Td=0, el PID no lo tomará en cuenta
+   // Inicializa integración e impone false en límites y condicional.
+   // El período se mide con micros() hasta que se llame a ConfigurarPeriodo().
+   Periodo=0;
+   IntervaloMaximo=0;
+   PoliticaDemora=(uint8_t)DemoraPID::Recortar;
+   Demoras=0;
+   SinSalto=false;
+   SaturacionExterna=false;
+   SalidaSaturada=false;
+   HaySalidaAnterior=false;
+   DiscretizacionIntegral=(uint8_t)DiscretizacionPID::Tustin;
+   DiscretizacionDerivativo=(uint8_t)DiscretizacionPID::EulerAtras;
+   FiltroDerivativo=0;
+   TiempoSeguimiento=0;
+   VariacionMaxima=0;
+   BandaMuerta=0;
+#ifndef CONTROLPID_COMPACTO
+   PesoProporcional=1;
+   PesoDerivativo=1;
+   Prealimentacion=0;
+   FuncionPrealimentacion=NULL;
+   ConfigurarEventos(0, 0, 0);
+   ConfigurarTablaGanancias(NULL, 0);
+   ConectarTelemetria(NULL, 0);
+#endif
+#ifdef CONTROLPID_CONCURRENTE
+   Secuencia=0;
+   SecuenciaAplicada=0;
+   OpcionesPublicadas=0;
+   for (uint8_t i=0; i<GRUPOS_PUBLICADOS; i++) {
+      Publicaciones[i]=0;
+      Aplicaciones[i]=0;
+   }
+#endif
+#ifdef CONTROLPID_INTERVALOS
+   Intervalos.Objetivo=0;
+   Intervalos.Tolerancia=0;
+   Intervalos.Reiniciar();
+#endif
+#ifdef CONTROLPID_PERFIL
+   Perfil.Reiniciar();                        // El contador de ciclos lo inicia ReiniciarPerfil()
+#endif
+   ConfigurarPID(KP, TI, TD);
+   LimitaSalida=false;
+   LimitaIntegral=false;
+   CondicionaIntegral=false;
+}
+//-------------------------------------------------------------------------------------
+
+void controlPID::ConfigurarPID(float KP, float TI, float TD)
+// Configura las constantes básicas del control PID 
+// Sirve para cambiar configuración inicial, sin modificar límites y condicional.
+{  // Kp puede ser negativo (esto último podría servir para controlar una planta cuya salida 
+   //                        tienda a bajar cuando aumente la señal de control. Ej.: heladera.) 
+   // Si Ti=0, el PID no lo tomará en cuenta
+   // Si Td=0, el PID no lo tomará en cuenta
+   // Resetea valores de integración.
+   Kp=KP;
+   Ti=TI;
+   Td=TD;
+   TiempoAnterior=0;
+   PrimeraMuestra=true;
+   ErrorAnterior=0;
+#ifndef CONTROLPID_COMPACTO
+   ProporcionalAnterior=0;
+#endif
+   Integral=0;
+   CalcularCoeficientes();
+   //LimitaSalida=false;
+   //LimitaIntegral=false;   
+   //CondicionaIntegral=false;
+}
+//-------------------------------------------------------------------------------------
+
+void controlPID::ConfigurarPeriodo(unsigned long PERIODO)
+// Establece un período de muestreo fijo en microsegundos (0 para medirlo con micros()).
+// No resetea la integral.
+{  Periodo=PERIODO;
+   PrimeraMuestra=true;
+   TiempoAnterior=0;
+   CalcularCoeficientes();
+}
+//-------------------------------------------------------------------------------------
+
+void controlPID::CalcularCoeficientes()
+// Coeficientes discretos para período fijo Ts.
+// Se recalculan sólo cuando cambian las constantes o el período.
+{  float Ts = Periodo / MILLON;
+   float Tf = (FiltroDerivativo>0) ? Td/FiltroDerivativo : 0;   // Constante del filtro (en segundos)
+   TiempoFiltro = Tf*MILLON;
+   CoefIntegral = 0;
+   CoefDerivativo = 0;
+   CoefFiltro = 1;
+   CoefSeguimiento = 0;
+   if (Periodo>0) {
+      if (Ti!=0) CoefIntegral = Kp*Ts/(2*Ti);
+      if (TiempoSeguimiento>0) CoefSeguimiento = min(Ts/TiempoSeguimiento, 1.0f);
+      if (Td!=0 && DiscretizacionDerivativo==(uint8_t)DiscretizacionPID::EulerAtras) {
+         CoefDerivativo = Kp*Td/(Tf+Ts);   // Sin filtro (Tf=0): Kp*Td/Ts
+         CoefFiltro = Ts/(Tf+Ts);
+      } else if (Td!=0) {
+         CoeficientesDerivativo(Ts, CoefFiltro, CoefDerivativo);
+      }
+   }
+}
+//-------------------------------------------------------------------------------------
+
+void controlPID::AplicarPID(float KP, float TI, float TD, boolean SIN_SALTO)
+// Cambia las constantes en medio del control.
+// Sin salto: conserva el estado y corrige la integral para compensar el cambio
+// de la componente proporcional, de modo que la salida sea continua. La señal de
+// la proporcional es la de la última muestra calculada (con referencia ponderada,
+// b*r-y y no el error).
+// Si no, resetea la integración como ConfigurarPID(), pero sin tocar TiempoAnterior:
+// LeerPublicacion() la llama dentro de Calcular(), con esta muestra ya medida.
+{  if (!SIN_SALTO) {
+      PrimeraMuestra=true;
+      ErrorAnterior=0;
+      Integral=0;
+   }
+#ifndef CONTROLPID_COMPACTO
+   else if (!PrimeraMuestra) Integral += (Kp-KP)*ProporcionalAnterior;
+#else
+   else if (!PrimeraMuestra) Integral += (Kp-KP)*ErrorAnterior;   // Sin pesos: la proporcional es el error
+#endif
+   Kp=KP;
+   Ti=TI;
+   Td=TD;
+   CalcularCoeficientes();
+}
+//-------------------------------------------------------------------------------------
+
+#ifndef CONTROLPID_COMPACTO
+boolean controlPID::ConfigurarTablaGanancias(const puntoGananciaPID* TABLA, uint8_t CANTIDAD)
+// La tabla queda en memoria de programa: sólo se guarda su dirección.
+{  if (TABLA==NULL) CANTIDAD=0;
+   TablaGanancias=TABLA;
+   CantidadGanancias=CANTIDAD;
+   SegmentoGanancias=0;
+   return CantidadGanancias>0;
+}
+//-------------------------------------------------------------------------------------
+
+void controlPID::PlanificarGanancias(float VARIABLE)
+// Ubica VARIABLE en la tabla (primero en el último segmento usado, si no, por
+// búsqueda binaria), interpola linealmente las constantes y las aplica sin salto.
+// Si no cambiaron (fuera de la tabla, o sin moverse VARIABLE) no se recalculan
+// los coeficientes: se llama en cada muestra.
+{  if (CantidadGanancias==0) return;
+   puntoGananciaPID Inferior, Superior;
+   uint8_t Ultimo = CantidadGanancias-1;
+   float KP, TI, TD;
+   memcpy_P(&Inferior, &TablaGanancias[0], sizeof(Inferior));
+   memcpy_P(&Superior, &TablaGanancias[Ultimo], sizeof(Superior));
+   if (CantidadGanancias==1 || VARIABLE<=Inferior.Variable) {
+      KP = Inferior.Kp;
+      TI = Inferior.Ti;
+      TD = Inferior.Td;
+   } else if (VARIABLE>=Superior.Variable) {
+      KP = Superior.Kp;
+      TI = Superior.Ti;
+      TD = Superior.Td;
+   } else {
+      // Segmento i: entre los puntos i e i+1.
+      uint8_t i = SegmentoGanancias;
+      memcpy_P(&Inferior, &TablaGanancias[i], sizeof(Inferior));
+      memcpy_P(&Superior, &TablaGanancias[i+1], sizeof(Superior));
+      if (VARIABLE<Inferior.Variable || VARIABLE>Superior.Variable) {
+         uint8_t Desde=0, Hasta=Ultimo;       // Invariante: Variable(Desde) < VARIABLE < Variable(Hasta)
+         while (Hasta-Desde > 1) {
+            uint8_t Medio = (Desde+Hasta)/2;
+            if (pgm_read_float(&TablaGanancias[Medio].Variable) <= VARIABLE) Desde=Medio;
+            else Hasta=Medio;
+         }
+         i = Desde;
+         SegmentoGanancias = i;
+         memcpy_P(&Inferior, &TablaGanancias[i], sizeof(Inferior));
+         memcpy_P(&Superior, &TablaGanancias[i+1], sizeof(Superior));
+      }
+      float Fraccion = (VARIABLE-Inferior.Variable) / (Superior.Variable-Inferior.Variable);
+      KP = Inferior.Kp + Fraccion*(Superior.Kp-Inferior.Kp);
+      TI = Inferior.Ti + Fraccion*(Superior.Ti-Inferior.Ti);
+      TD = Inferior.Td + Fraccion*(Superior.Td-Inferior.Td);
+   }
+   if (KP==Kp && TI==Ti && TD==Td) return;
+   AplicarPID(KP, TI, TD, true);
+}
+//-------------------------------------------------------------------------------------
+#endif
+
+boolean controlPID::TransferenciaSinSalto()
+{  return SinSalto;
+}
+//-------------------------------------------------------------------------------------
+
+boolean controlPID::TransferenciaSinSalto(boolean RESPUESTA)
+{  SinSalto=RESPUESTA;
+   return SinSalto;
+}
+//-------------------------------------------------------------------------------------
+
+#ifdef CONTROLPID_CONCURRENTE
+void controlPID::IniciarPublicacion()
+// Escritor del seqlock: el contador queda impar mientras se escribe el bloque.
+// Un único escritor (si hay varios, deben excluirse entre ellos).
+{  Secuencia = Secuencia + 1;
+   BarreraPID();
+}
+//-------------------------------------------------------------------------------------
+
+void controlPID::TerminarPublicacion()
+{  BarreraPID();
+   Secuencia = Secuencia + 1;
+}
+//-------------------------------------------------------------------------------------
+
+void controlPID::PublicarPID(float KP, float TI, float TD)
+{  IniciarPublicacion();
+   KpPublicado=KP;
+   TiPublicado=TI;
+   TdPublicado=TD;
+   Publicaciones[PUBLICA_CONSTANTES] = Publicaciones[PUBLICA_CONSTANTES] + 1;
+   TerminarPublicacion();
+}
+//-------------------------------------------------------------------------------------
+
+void controlPID::PublicarLimitarSalida(boolean RESPUESTA, float SMIN, float SMAX)
+{  IniciarPublicacion();
+   SalidaMinPublicada=SMIN;
+   SalidaMaxPublicada=SMAX;
+   if (RESPUESTA) OpcionesPublicadas = OpcionesPublicadas | (1 << PUBLICA_SALIDA);
+   else OpcionesPublicadas = OpcionesPublicadas & ~(1 << PUBLICA_SALIDA);
+   Publicaciones[PUBLICA_SALIDA] = Publicaciones[PUBLICA_SALIDA] + 1;
+   TerminarPublicacion();
+}
+//-------------------------------------------------------------------------------------
+
+void controlPID::PublicarLimitarIntegral(boolean RESPUESTA)
+{  IniciarPublicacion();
+   if (RESPUESTA) OpcionesPublicadas = OpcionesPublicadas | (1 << PUBLICA_INTEGRAL);
+   else OpcionesPublicadas = OpcionesPublicadas & ~(1 << PUBLICA_INTEGRAL);
+   Publicaciones[PUBLICA_INTEGRAL] = Publicaciones[PUBLICA_INTEGRAL] + 1;
+   TerminarPublicacion();
+}
+//-------------------------------------------------------------------------------------
+
+void controlPID::PublicarCondicionarIntegral(boolean RESPUESTA)
+{  IniciarPublicacion();
+   if (RESPUESTA) OpcionesPublicadas = OpcionesPublicadas | (1 << PUBLICA_CONDICIONAL);
+   else OpcionesPublicadas = OpcionesPublicadas & ~(1 << PUBLICA_CONDICIONAL);
+   Publicaciones[PUBLICA_CONDICIONAL] = Publicaciones[PUBLICA_CONDICIONAL] + 1;
+   TerminarPublicacion();
+}
+//-------------------------------------------------------------------------------------
+
+void controlPID::LeerPublicacion()
+// Lector del seqlock: nunca espera. Si el bloque se está escribiendo o cambió
+// mientras se leía, sigue con la configuración anterior y reintenta en la
+// próxima muestra. Cada grupo tiene su contador: se aplican sólo los grupos
+// publicados desde la última lectura, una vez cada uno.
+{  secuenciaPID Inicio = Secuencia;
+   if (Inicio & 1) return;
+   BarreraPID();
+   float KP=KpPublicado;
+   float TI=TiPublicado;
+   float TD=TdPublicado;
+   float SMIN=SalidaMinPublicada;
+   float SMAX=SalidaMaxPublicada;
+   uint8_t Opciones=OpcionesPublicadas;
+   uint8_t Grupos[GRUPOS_PUBLICADOS];
+   for (uint8_t i=0; i<GRUPOS_PUBLICADOS; i++) Grupos[i]=Publicaciones[i];
+   BarreraPID();
+   if (Secuencia != Inicio) return;
+   SecuenciaAplicada = Inicio;
+   if (Grupos[PUBLICA_CONSTANTES] != Aplicaciones[PUBLICA_CONSTANTES]) AplicarPID(KP, TI, TD, SinSalto);
+   if (Grupos[PUBLICA_SALIDA] != Aplicaciones[PUBLICA_SALIDA])
+      LimitarSalida((Opciones & (1 << PUBLICA_SALIDA)) != 0, SMIN, SMAX);
+   if (Grupos[PUBLICA_INTEGRAL] != Aplicaciones[PUBLICA_INTEGRAL])
+      LimitarIntegral((Opciones & (1 << PUBLICA_INTEGRAL)) != 0);
+   if (Grupos[PUBLICA_CONDICIONAL] != Aplicaciones[PUBLICA_CONDICIONAL])
+      CondicionarIntegral((Opciones & (1 << PUBLICA_CONDICIONAL)) != 0);
+   for (uint8_t i=0; i<GRUPOS_PUBLICADOS; i++) Aplicaciones[i]=Grupos[i];
+}
+//-------------------------------------------------------------------------------------
+#endif
+
+boolean controlPID::LimitarSalida()
+// Devuelve el valor de la variable privada LimitaSalida
+// que indica si nuestro PID está configurado para limitar su salida.
+{  return LimitaSalida;
+}
+//-------------------------------------------------------------------------------------
+
+boolean controlPID::LimitarSalida(boolean RESPUESTA)
+// Configura si limitará la salida...
+// No permite activar límites si antes no fueron establecidos.
+{  LimitaSalida=RESPUESTA;
+   if (SalidaMax==0 && SalidaMin==0) {
+     // ...no voy a limitar porque no tengo límites definidos.
+     LimitaSalida=false;
+   }
+   return LimitaSalida;
+}//-------------------------------------------------------------------------------------
+
+boolean controlPID::LimitarSalida(boolean RESPUESTA, float SMIN, float SMAX)
+// Configura si limitará la salida entre SMAX y SMIN.
+// Se puede establecer los límites pero no activarlos aún.
+// No activa con SMIN=SMAX.
+// No activa si SMIN>SMAX.
+{  SalidaMax=SMAX;
+   SalidaMin=SMIN;
+   LimitaSalida=RESPUESTA;
+   // La forma de desactivar este límite es:
+   // 1) Volviendo a llamar esta función con RESPUESTA=false
+   // 2) Llamando a LimitarSalida(false)
+   // También se pueden poner límites muy grandes.
+   if (SalidaMax==SalidaMin) {
+     // ...no voy a limitar porque no tengo límites definidos.
+     LimitaSalida=false;
+   }
+   if (SalidaMin>SalidaMax) {
+     // ...no voy a limitar porque están mal configurados.
+     LimitaSalida=false;
+   }
+   return LimitaSalida;
+}
+//-------------------------------------------------------------------------------------
+
+boolean controlPID::LimitarIntegral()
+// Devuelve el valor de la variable privada LimitaIntegral
+// que indica si nuestro PID está configurado para limitar la integral.
+{  return LimitaIntegral;
+}
+//-------------------------------------------------------------------------------------
+
+boolean controlPID::LimitarIntegral(boolean RESPUESTA)
+// Configura los límites al integrador entre los mismos márgenes de la salida.
+// Para establecer el límite, previamente se debe haber configurado los límites de salida.
+{  LimitaIntegral=RESPUESTA;  // Puede ser true o false
+   if (SalidaMax==SalidaMin) {
+     // ...no voy a limitar porque no tengo límites definidos.
+     LimitaIntegral=false;
+   }
+   return LimitaIntegral;
+}
+//-------------------------------------------------------------------------------------
+
+boolean controlPID::RetrocalcularIntegral()
+// Indica si el retrocálculo de la integral está activado.
+{  return TiempoSeguimiento>0;
+}
+//-------------------------------------------------------------------------------------
+
+boolean controlPID::RetrocalcularIntegral(boolean RESPUESTA, float TT)
+// Establece si la integral se corrige con (salida saturada - salida calculada)*dt/TT.
+// Deben haberse preestablecido los límites de salida.
+{  TiempoSeguimiento = (RESPUESTA && TT>0 && LimitaSalida) ? TT : 0;
+   CalcularCoeficientes();
+   return TiempoSeguimiento>0;
+}
+//-------------------------------------------------------------------------------------
+
+boolean controlPID::CondicionarIntegral()
+// Devuelve el valor de CondicionaIntegral.
+{  return CondicionaIntegral;
+}
+//-------------------------------------------------------------------------------------
+
+boolean controlPID::CondicionarIntegral(boolean RESPUESTA)
+// Establece si debo pausar la integración cuando la salida está saturada.
+// Deben haberse preestablecido los límites de salida.
+{  
+   CondicionaIntegral = RESPUESTA;
+   if (!LimitaSalida) CondicionaIntegral=false;
+   return CondicionaIntegral;
+}
+//-------------------------------------------------------------------------------------
+
+float controlPID::Controlar(float ERROR)
+// Calcula Salida en función de la señal error y los parámetros del PID
+{  if (Periodo>0) {
+      // Período fijo: no necesito medir el tiempo.
+      return Calcular(ERROR, ERROR, ERROR, Periodo);
+   }
+   return Controlar(ERROR, micros());
+}
+//-------------------------------------------------------------------------------------
+
+float controlPID::Controlar(float ERROR, unsigned long TIEMPO)
+// Calcula Salida con el tiempo actual TIEMPO (en microsegundos) provisto externamente.
+{  return ControlarIntervalo(ERROR, MedirIntervalo(TIEMPO));
+}
+//-------------------------------------------------------------------------------------
+
+float controlPID::ControlarIntervalo(float ERROR, unsigned long INTERVALO)
+// Calcula Salida con el intervalo desde la muestra anterior (en microsegundos) ya calculado.
+{
+#ifdef CONTROLPID_INTERVALOS
+   if (!PrimeraMuestra) Intervalos.Registrar(INTERVALO);
+#endif
+   return Calcular(ERROR, ERROR, ERROR, INTERVALO);
+}
+//-------------------------------------------------------------------------------------
+
+float controlPID::ControlarReferencia(float REFERENCIA, float MEDICION)
+// PID de dos grados de libertad: integra r-y, la proporcional actúa sobre b*r-y
+// y la derivativa sobre c*r-y.
+{
+#ifdef CONTROLPID_COMPACTO
+   const float PesoProporcional = 1, PesoDerivativo = 1;
+#endif
+   if (Periodo>0) {
+      return Calcular(REFERENCIA-MEDICION, PesoProporcional*REFERENCIA-MEDICION,
+                      PesoDerivativo*REFERENCIA-MEDICION, Periodo);
+   }
+   return ControlarReferencia(REFERENCIA, MEDICION, micros());
+}
+//-------------------------------------------------------------------------------------
+
+float controlPID::ControlarReferencia(float REFERENCIA, float MEDICION, unsigned long TIEMPO)
+// Ídem, con el tiempo actual TIEMPO (en microsegundos) provisto externamente.
+{  unsigned long Intervalo = MedirIntervalo(TIEMPO);
+#ifdef CONTROLPID_COMPACTO
+   const float PesoProporcional = 1, PesoDerivativo = 1;
+#endif
+#ifdef CONTROLPID_INTERVALOS
+   if (!PrimeraMuestra) Intervalos.Registrar(Intervalo);
+#endif
+   return Calcular(REFERENCIA-MEDICION, PesoProporcional*REFERENCIA-MEDICION,
+                   PesoDerivativo*REFERENCIA-MEDICION, Intervalo);
+}
+//-------------------------------------------------------------------------------------
+
+#ifndef CONTROLPID_COMPACTO
+void controlPID::PonderarReferencia(float B, float C)
+// Pesos de la referencia en la proporcional (B) y la derivativa (C).
+{  PesoProporcional = B;
+   PesoDerivativo = C;
+}
+//-------------------------------------------------------------------------------------
+#endif
+
+float controlPID::ControlarMedicion(float ERROR, float MEDICION)
+// Como Controlar(ERROR), pero la componente derivativa actúa sobre -MEDICION.
+{  if (Periodo>0) {
+      return Calcular(ERROR, ERROR, -MEDICION, Periodo);
+   }
+   return ControlarMedicion(ERROR, MEDICION, micros());
+}
+//-------------------------------------------------------------------------------------
+
+float controlPID::ControlarMedicion(float ERROR, float MEDICION, unsigned long TIEMPO)
+// Ídem, con el tiempo actual TIEMPO (en microsegundos) provisto externamente.
+{  unsigned long Intervalo = MedirIntervalo(TIEMPO);
+#ifdef CONTROLPID_INTERVALOS
+   if (!PrimeraMuestra) Intervalos.Registrar(Intervalo);
+#endif
+   return Calcular(ERROR, ERROR, -MEDICION, Intervalo);
+}
+//-------------------------------------------------------------------------------------
+
+#ifndef CONTROLPID_COMPACTO
+float controlPID::ControlarPrealimentado(float ERROR, float PREALIMENTACION)
+// Como Controlar(ERROR), sumando PREALIMENTACION a la salida antes de saturarla.
+{  Prealimentacion = PREALIMENTACION;
+   return Controlar(ERROR);
+}
+//-------------------------------------------------------------------------------------
+
+float controlPID::ControlarPrealimentado(float ERROR, float PREALIMENTACION, unsigned long TIEMPO)
+// Ídem, con el tiempo actual TIEMPO (en microsegundos) provisto externamente.
+{  Prealimentacion = PREALIMENTACION;
+   return Controlar(ERROR, TIEMPO);
+}
+//-------------------------------------------------------------------------------------
+
+void controlPID::FijarPrealimentacion(float PREALIMENTACION)
+// Valor que se suma a la salida en cada muestra (0 para quitarlo).
+{  Prealimentacion = PREALIMENTACION;
+}
+//-------------------------------------------------------------------------------------
+
+void controlPID::ConfigurarPrealimentacion(float (*FUNCION)())
+// Función que devuelve la prealimentación en cada muestra (NULL para usar el valor fijo).
+{  FuncionPrealimentacion = FUNCION;
+}
+//-------------------------------------------------------------------------------------
+#endif
+
+unsigned long controlPID::MedirIntervalo(unsigned long TIEMPO)
+// Intervalo desde la muestra anterior (0 en la primera) y actualiza TiempoAnterior.
+{  unsigned long Intervalo = 0;
+   // micros() es de 32 bits: la resta en 32 bits es correcta aunque micros() 
+   // haya desbordado (cada ~71 minutos) entre ambas muestras.
+   if (!PrimeraMuestra) Intervalo = (uint32_t)(TIEMPO-TiempoAnterior);
+   TiempoAnterior = TIEMPO;
+   return Intervalo;
+}
+//-------------------------------------------------------------------------------------
+
+float controlPID::Calcular(float ERROR, float PROPORCIONAL, float DERIVADA, unsigned long INTERVALO)
+// Calcula Salida en función de la señal error (que se integra), las señales para la
+// componente proporcional y la derivativa (el error, o b*r-y y c*r-y con referencia
+// ponderada), el intervalo desde la muestra anterior (en microsegundos) y los
+// parámetros del PID.
+{  boolean SalidaEstaSaturada = false;
+#ifdef CONTROLPID_SIN_TELEMETRIA
+   float Proporcional, Derivativo;        // Sin telemetría no se guardan en el objeto
+#endif
+#ifdef CONTROLPID_CONCURRENTE
+   if (Secuencia != SecuenciaAplicada) LeerPublicacion();
+#endif
+#ifndef CONTROLPID_COMPACTO
+   TiempoTelemetria += INTERVALO;         // Antes de la banda muerta y del recorte de una demora
+#endif
+   if (EnBandaMuerta(ERROR, DERIVADA)) return Salida;
+   float SalidaAnterior = Salida;
+#ifndef CONTROLPID_COMPACTO
+   float Directa = FuncionPrealimentacion ? FuncionPrealimentacion() : Prealimentacion;
+#else
+   const float Directa = 0;               // Sin prealimentación
+#endif
+#ifdef CONTROLPID_PERFIL
+   uint32_t CicloInicial = CiclosPerfil();
+#endif
+   boolean IntegralBloqueada = false;
+   float SalidaSinLimitar;
+   INTERVALO = RevisarDemora(INTERVALO);
+   // Sin muestra anterior (o sin tiempo transcurrido) no integra ni deriva:
+   boolean HayMuestraAnterior = !PrimeraMuestra && (Periodo>0 || INTERVALO>0);
+   
+   // PROPORCIONAL --------------------------------------------------------------
+   Proporcional = Kp*PROPORCIONAL;
+
+   // DERIVATIVO ----------------------------------------------------------------
+   Derivativo = Derivar(DERIVADA, INTERVALO, HayMuestraAnterior);
+
+   // ¿Debo saturar salida? -----------------------------------------------------
+   Salida = Proporcional + Integral + Derivativo + Directa;
+   if (LimitaSalida && ((Salida > SalidaMax) || (Salida<SalidaMin))) {
+      // Debo saturar la salida...
+      SalidaEstaSaturada = true;
+   }
+   if (VariacionMaxima>0 && HaySalidaAnterior && fabs(Salida-SalidaAnterior) > VariacionMaxima) {
+      // ...o limitar su variación (también cuenta como saturada):
+      SalidaEstaSaturada = true;
+   }
+   if (SaturacionExterna) {
+      // ...o está saturado lo que sigue a la salida (lazo interno de una cascada):
+      SalidaEstaSaturada = true;
+   }
+   
+   // INTEGRAL ------------------------------------------------------------------
+   if (HayMuestraAnterior && Ti!=0) {
+      // Cumplidas las dos primeras condiciones para integral el error:
+      
+      if (!CondicionaIntegral || !SalidaEstaSaturada) {
+        // Si no está configurada la condición o si no está salutarda la salida, 
+        // puedo hacer la integral:
+        if (Periodo>0) {
+          Integral += CoefIntegral * SumaIntegral(ERROR);
+        } else {
+          Integral += Kp * SumaIntegral(ERROR) * INTERVALO / (2*Ti*MILLON);
+        }
+      }
+      else IntegralBloqueada = true;
+
+      if (LimitaIntegral) {
+        // Debo saturar la integral:
+        Integral = min(Integral, (acumuladorPID)SalidaMax);
+        Integral = max(Integral, (acumuladorPID)SalidaMin);
+      }
+   }
+
+   // Termina componente integral ----------------------------------------------
+   
+   // Cáculo final completo: 
+   Salida = Proporcional + Integral + Derivativo + Directa;
+   SalidaSinLimitar = Salida;
+
+   if (LimitaSalida) {
+      // Debo saturar la salida:
+      Salida = min(Salida, SalidaMax);
+      Salida = max(Salida, SalidaMin);
+   }
+   if (VariacionMaxima>0 && HaySalidaAnterior) {
+      // Debo limitar la variación respecto de la salida anterior (aunque no se
+      // haya integrado ni derivado: tras reconfigurar, la salida puede saltar):
+      Salida = min(Salida, SalidaAnterior+VariacionMaxima);
+      Salida = max(Salida, SalidaAnterior-VariacionMaxima);
+   }
+   if (TiempoSeguimiento>0 && HayMuestraAnterior && Ti!=0 && Salida!=SalidaSinLimitar) {
+      // Retrocálculo: la integral sigue a la salida saturada (o de variación limitada)
+      // con constante Tt, de modo que al dejar de saturar no queda enrolada.
+      float Avance = (Periodo>0) ? CoefSeguimiento : min(INTERVALO/(TiempoSeguimiento*MILLON), 1.0f);
+      Integral += Avance*(Salida-SalidaSinLimitar);
+   }
+   SalidaSaturada = (Salida!=SalidaSinLimitar);
+   PrimeraMuestra = false;
+   HaySalidaAnterior = true;
+   ErrorAnterior = ERROR;
+#ifndef CONTROLPID_COMPACTO
+   ProporcionalAnterior = PROPORCIONAL;
+#endif
+#ifdef CONTROLPID_PERFIL
+   Perfil.Registrar(CiclosTranscurridos(CicloInicial), Salida!=SalidaSinLimitar, IntegralBloqueada);
+#endif
+#ifndef CONTROLPID_COMPACTO
+   if (Telemetria) {
+      Telemetria->Registrar(LazoTelemetria, TiempoTelemetria, ERROR, Proporcional, Integral, Derivativo, Salida,
+                            (Salida!=SalidaSinLimitar ? muestraPID::SATURADA : 0)
+                          | (IntegralBloqueada ? muestraPID::INTEGRAL_BLOQUEADA : 0)
+                          | (!HayMuestraAnterior ? muestraPID::PRIMERA : 0));
+   }
+#else
+   (void)IntegralBloqueada;               // Sin cola: si no hay perfil, no se usa
+#endif
+   return Salida;
+   // Termina funcion PID ------------------------------------------------------
+}
+//-------------------------------------------------------------------------------------
+
+void controlPID::GuardarEstado(estadoPID& ESTADO)
+// Copia el estado en ESTADO y calcula su CRC.
+{  memset(&ESTADO, 0, sizeof(estadoPID));     // Sin basura en el relleno: el CRC es reproducible
+   ESTADO.Version = estadoPID::VERSION_ESTADOPID;
+   ESTADO.Tamano = sizeof(estadoPID);
+   ESTADO.Kp = Kp;
+   ESTADO.Ti = Ti;
+   ESTADO.Td = Td;
+   ESTADO.SalidaMax = SalidaMax;
+   ESTADO.SalidaMin = SalidaMin;
+   ESTADO.Integral = Integral;
+   ESTADO.Salida = Salida;
+#ifndef CONTROLPID_COMPACTO
+   ESTADO.Prealimentacion = Prealimentacion;
+#endif
+   ESTADO.Periodo = Periodo;
+   ESTADO.IntervaloMaximo = IntervaloMaximo;
+   ESTADO.FiltroDerivativo = FiltroDerivativo;
+   ESTADO.TiempoSeguimiento = TiempoSeguimiento;
+   ESTADO.VariacionMaxima = VariacionMaxima;
+   ESTADO.BandaMuerta = BandaMuerta;
+#ifndef CONTROLPID_COMPACTO
+   ESTADO.PesoProporcional = PesoProporcional;
+   ESTADO.PesoDerivativo = PesoDerivativo;
+   ESTADO.UmbralEvento = UmbralEvento;
+   ESTADO.UmbralSalida = UmbralSalida;
+   ESTADO.IntervaloEvento = IntervaloEvento;
+#else
+   ESTADO.PesoProporcional = 1;               // Los valores por omisión: el estado es el mismo
+   ESTADO.PesoDerivativo = 1;                 // con y sin CONTROLPID_COMPACTO
+#endif
+   ESTADO.Opciones = (LimitaSalida ? estadoPID::OPCION_LIMITA_SALIDA : 0)
+                   | (LimitaIntegral ? estadoPID::OPCION_LIMITA_INTEGRAL : 0)
+                   | (CondicionaIntegral ? estadoPID::OPCION_CONDICIONA_INTEGRAL : 0)
+                   | (SinSalto ? estadoPID::OPCION_SIN_SALTO : 0)
+                   | (PoliticaDemora << 4);
+   ESTADO.Discretizacion = DiscretizacionIntegral | (DiscretizacionDerivativo << 2)
+                         | estadoPID::DISCRETIZACION_GUARDADA;
+   ESTADO.Crc = CrcPID(&ESTADO, offsetof(estadoPID, Crc));
+}
+//-------------------------------------------------------------------------------------
+
+boolean controlPID::RestaurarEstado(const estadoPID& ESTADO)
+// Sólo copia campos: no hay cálculos aparte de los coeficientes de período fijo.
+{  if (ESTADO.Version != estadoPID::VERSION_ESTADOPID || ESTADO.Tamano != sizeof(estadoPID)) return false;
+   if (ESTADO.Crc != CrcPID(&ESTADO, offsetof(estadoPID, Crc))) return false;
+   if (((ESTADO.Opciones & estadoPID::OPCION_POLITICA_DEMORA) >> 4) > (uint8_t)DemoraPID::Apagar) return false;
+   Kp = ESTADO.Kp;
+   Ti = ESTADO.Ti;
+   Td = ESTADO.Td;
+   SalidaMax = ESTADO.SalidaMax;
+   SalidaMin = ESTADO.SalidaMin;
+   Integral = ESTADO.Integral;
+   Salida = ESTADO.Salida;
+#ifndef CONTROLPID_COMPACTO
+   Prealimentacion = ESTADO.Prealimentacion;
+#endif
+   Periodo = ESTADO.Periodo;
+   IntervaloMaximo = ESTADO.IntervaloMaximo;
+   FiltroDerivativo = ESTADO.FiltroDerivativo;
+   TiempoSeguimiento = ESTADO.TiempoSeguimiento;
+   VariacionMaxima = ESTADO.VariacionMaxima;
+   BandaMuerta = ESTADO.BandaMuerta;
+#ifndef CONTROLPID_COMPACTO
+   PesoProporcional = ESTADO.PesoProporcional;
+   PesoDerivativo = ESTADO.PesoDerivativo;
+   // Modo por eventos; la primera ControlarPorEvento() vuelve a informar la salida:
+   ConfigurarEventos(ESTADO.UmbralEvento, ESTADO.IntervaloEvento, ESTADO.UmbralSalida);
+#endif
+   LimitaSalida = (ESTADO.Opciones & estadoPID::OPCION_LIMITA_SALIDA) != 0;
+   LimitaIntegral = (ESTADO.Opciones & estadoPID::OPCION_LIMITA_INTEGRAL) != 0;
+   CondicionaIntegral = (ESTADO.Opciones & estadoPID::OPCION_CONDICIONA_INTEGRAL) != 0;
+   SinSalto = (ESTADO.Opciones & estadoPID::OPCION_SIN_SALTO) != 0;
+   PoliticaDemora = (ESTADO.Opciones & estadoPID::OPCION_POLITICA_DEMORA) >> 4;
+   if (ESTADO.Discretizacion & estadoPID::DISCRETIZACION_GUARDADA) {
+      DiscretizacionIntegral = ESTADO.Discretizacion & 0x03;
+      DiscretizacionDerivativo = (ESTADO.Discretizacion >> 2) & 0x03;
+   } else {
+      DiscretizacionIntegral = (uint8_t)DiscretizacionPID::Tustin;
+      DiscretizacionDerivativo = (uint8_t)DiscretizacionPID::EulerAtras;
+   }
+   TiempoAnterior = 0;
+   PrimeraMuestra = true;                     // El tiempo de la muestra anterior no vale tras un reinicio
+   HaySalidaAnterior = true;                  // La salida guardada sí: la variación parte de ella
+   CalcularCoeficientes();
+   return true;
+}
+//-------------------------------------------------------------------------------------
+
+unsigned long controlPID::RevisarDemora(unsigned long INTERVALO)
+// Aplica la política de demora si INTERVALO supera el máximo y devuelve el intervalo a usar.
+{  if (IntervaloMaximo>0 && INTERVALO>IntervaloMaximo && !PrimeraMuestra) {
+      // Demora (bloqueo del programa o tiempo que retrocede): un intervalo
+      // tan grande haría saltar la integral.
+      Demoras++;
+      switch ((DemoraPID)PoliticaDemora) {
+         case DemoraPID::Recortar:      INTERVALO = IntervaloMaximo; break;
+         case DemoraPID::Resincronizar: PrimeraMuestra = true;       break;
+         case DemoraPID::Apagar: {
+            // MedirIntervalo() ya guardó el tiempo de esta muestra: Apagar() lo
+            // borraría y el intervalo siguiente se mediría desde 0.
+            unsigned long Tiempo = TiempoAnterior;
+            Apagar();
+            TiempoAnterior = Tiempo;
+            break;
+         }
+      }
+   }
+   return INTERVALO;
+}
+//-------------------------------------------------------------------------------------
+
+float controlPID::Derivar(float DERIVADA, unsigned long INTERVALO, boolean HAY_MUESTRA)
+// Componente derivativa de la señal DERIVADA. Actualiza el estado del filtro.
+{  float Resultado = 0;
+   float AvanceFiltro = 1;                // Fracción de la señal que entra al filtro derivativo
+   if (DiscretizacionDerivativo!=(uint8_t)DiscretizacionPID::EulerAtras) {
+      // Demás aproximaciones: recurrencia sobre la componente derivativa anterior
+      // y la señal sin filtrar.
+      if (HAY_MUESTRA && Td!=0) {
+         float Ad = CoefFiltro, Bd = CoefDerivativo;
+         if (Periodo==0) CoeficientesDerivativo(INTERVALO/MILLON, Ad, Bd);
+         Resultado = Ad*DerivativoAnterior + Bd*(DERIVADA-DerivadaAnterior);
+      }
+      DerivadaAnterior = DERIVADA;
+      DerivativoAnterior = Resultado;
+      return Resultado;
+   }
+   if (HAY_MUESTRA && Td!=0) {  
+      // Dos condiciones para componente derivativa:
+      // 1) Que no sea el primer cálculo y 2) Td seteado
+      // DerivadaAnterior es la señal filtrada con Tf=Td/N (sin filtro, la señal anterior):
+      // derivar la señal filtrada equivale a Kp*Td*s/(1+Tf*s) con Euler hacia atrás.
+      if (Periodo>0) {
+         Resultado = CoefDerivativo*(DERIVADA-DerivadaAnterior);
+         AvanceFiltro = CoefFiltro;
+      } else {
+         float Inversa = 1 / (TiempoFiltro + INTERVALO);   // Tf y el intervalo en microsegundos
+         Resultado = Kp*Td*(DERIVADA-DerivadaAnterior)*MILLON * Inversa;
+         AvanceFiltro = INTERVALO * Inversa;
+      }
+   }
+   if (TiempoFiltro>0 && HAY_MUESTRA) DerivadaAnterior += AvanceFiltro*(DERIVADA-DerivadaAnterior);
+   else DerivadaAnterior = DERIVADA;
+   DerivativoAnterior = Resultado;
+   return Resultado;
+}
+//-------------------------------------------------------------------------------------
+
+void controlPID::CoeficientesDerivativo(float TS, float& AD, float& BD)
+// Discretización de Kp*Td*s/(1+Tf*s):
+//    EulerAtras     s = (1-z^-1)/Ts
+//    EulerAdelante  s = (1-z^-1)/(Ts*z^-1)
+//    Tustin         s = C*(1-z^-1)/(1+z^-1), con C = 2/Ts, o con precompensación
+//                   C = (1/Tf)/tan(Ts/(2*Tf)): la respuesta coincide en el polo 1/Tf.
+// Donde la aproximación pedida no es estable se usa la más cercana que sí lo es:
+//    EulerAdelante con Ts >= 2*Tf      polo en Ad = 1-Ts/Tf <= -1: EulerAtras
+//    Tustin sin filtro (Tf=0)          polo en z=-1 (oscila sin amortiguarse): EulerAtras
+//    Precompensado con Ts >= pi*Tf     Ts/(2*Tf) pasa pi/2 y C < 0: Tustin sin precompensar
+{  float Tf = TiempoFiltro/MILLON;
+   DiscretizacionPID Metodo = (DiscretizacionPID)DiscretizacionDerivativo;
+   if (Metodo==DiscretizacionPID::EulerAdelante && TS < 2*Tf) {
+      AD = 1 - TS/Tf;
+      BD = Kp*Td/Tf;
+   } else if ((Metodo==DiscretizacionPID::Tustin || Metodo==DiscretizacionPID::TustinPrecompensado) && Tf>0) {
+      float C = (Metodo==DiscretizacionPID::TustinPrecompensado && TS < 3.14159265f*Tf)
+              ? 1/(Tf*tan(TS/(2*Tf))) : 2/TS;
+      AD = (C*Tf-1)/(C*Tf+1);
+      BD = C*Kp*Td/(C*Tf+1);
+   } else {
+      AD = Tf/(Tf+TS);
+      BD = Kp*Td/(Tf+TS);
+   }
+}
+//-------------------------------------------------------------------------------------
+
+float controlPID::SumaIntegral(float ERROR)
+// El CoefIntegral es para el trapecio (Kp*Ts/(2*Ti)): los rectángulos suman dos veces la muestra.
+{  switch ((DiscretizacionPID)DiscretizacionIntegral) {
+      case DiscretizacionPID::EulerAtras:    return 2*ERROR;
+      case DiscretizacionPID::EulerAdelante: return 2*ErrorAnterior;
+      default:                               return ERROR+ErrorAnterior;
+   }
+}
+//-------------------------------------------------------------------------------------
+
+void controlPID::ConfigurarDiscretizacion(DiscretizacionPID INTEGRAL, DiscretizacionPID DERIVATIVO)
+// Cambia la aproximación discreta. El estado del filtro derivativo depende de ella:
+// la próxima muestra arranca de nuevo (no integra ni deriva).
+{  DiscretizacionIntegral = (uint8_t)INTEGRAL;
+   DiscretizacionDerivativo = (uint8_t)DERIVATIVO;
+   PrimeraMuestra = true;
+   TiempoAnterior = 0;
+   CalcularCoeficientes();
+}
+//-------------------------------------------------------------------------------------
+
+boolean controlPID::ObtenerCoeficientes(coeficientesPID& COEFICIENTES)
+// C(z) = Kp + Ki*(c0+c1*z^-1)/(1-z^-1) + Bd*(1-z^-1)/(1-Ad*z^-1), con Ki = Kp*Ts/Ti
+// y (c0,c1) = (1/2,1/2) en Tustin, (1,0) en EulerAtras y (0,1) en EulerAdelante.
+// Con denominador común (1-z^-1)*(1-Ad*z^-1) queda un biquad.
+{  if (Periodo==0) return false;
+   float Ki = 2*CoefIntegral;
+   float c0 = 0.5f, c1 = 0.5f;
+   if (DiscretizacionIntegral==(uint8_t)DiscretizacionPID::EulerAtras) { c0 = 1; c1 = 0; }
+   if (DiscretizacionIntegral==(uint8_t)DiscretizacionPID::EulerAdelante) { c0 = 0; c1 = 1; }
+   float Ad = 0, Bd = 0;
+   if (Td!=0) {
+      if (DiscretizacionDerivativo==(uint8_t)DiscretizacionPID::EulerAtras) {
+         Ad = 1 - CoefFiltro;
+         Bd = CoefDerivativo;
+      } else {
+         Ad = CoefFiltro;
+         Bd = CoefDerivativo;
+      }
+   }
+   COEFICIENTES.B0 = Kp + Ki*c0 + Bd;
+   COEFICIENTES.B1 = -Kp*(1+Ad) + Ki*(c1 - c0*Ad) - 2*Bd;
+   COEFICIENTES.B2 = Kp*Ad - Ki*c1*Ad + Bd;
+   COEFICIENTES.A1 = 1 + Ad;
+   COEFICIENTES.A2 = -Ad;
+   return true;
+}
+//-------------------------------------------------------------------------------------
+
+float controlPID::ControlarIncremental(float ERROR)
+// Calcula el incremento de la señal de control (forma de velocidad).
+{  if (Periodo>0) {
+      return CalcularIncremento(ERROR, Periodo);
+   }
+   return ControlarIncremental(ERROR, micros());
+}
+//-------------------------------------------------------------------------------------
+
+float controlPID::ControlarIncremental(float ERROR, unsigned long TIEMPO)
+// Ídem, con el tiempo actual TIEMPO (en microsegundos) provisto externamente.
+{  unsigned long Intervalo = MedirIntervalo(TIEMPO);
+#ifdef CONTROLPID_INTERVALOS
+   if (!PrimeraMuestra) Intervalos.Registrar(Intervalo);
+#endif
+   return CalcularIncremento(ERROR, Intervalo);
+}
+//-------------------------------------------------------------------------------------
+
+float controlPID::CalcularIncremento(float ERROR, unsigned long INTERVALO)
+// Forma de velocidad: Kp*(e-e') + Kp*dt/Ti*e + (D-D'). No hay integral acumulada
+// (ni enrole): el valor absoluto de la salida lo lleva el actuador.
+{  float Incremento = 0;
+#ifdef CONTROLPID_CONCURRENTE
+   if (Secuencia != SecuenciaAplicada) LeerPublicacion();
+#endif
+   if (EnBandaMuerta(ERROR, ERROR)) return Salida = 0;
+#ifdef CONTROLPID_PERFIL
+   uint32_t CicloInicial = CiclosPerfil();
+#endif
+   INTERVALO = RevisarDemora(INTERVALO);
+   boolean HayMuestraAnterior = !PrimeraMuestra && (Periodo>0 || INTERVALO>0);
+   float Previo = DerivativoAnterior;
+   float Componente = Derivar(ERROR, INTERVALO, HayMuestraAnterior);
+#ifndef CONTROLPID_SIN_TELEMETRIA
+   Derivativo = Componente;               // Para ObtenerDerivativo()
+#endif
+   if (HayMuestraAnterior) {
+      Incremento = Kp*(ERROR-ErrorAnterior) + (Componente-Previo);
+      if (Ti!=0) {
+         if (Periodo>0) {
+            Incremento += 2*CoefIntegral * ERROR;     // Kp*Ts/Ti
+         } else {
+            Incremento += Kp * ERROR * INTERVALO / (Ti*MILLON);
+         }
+      }
+   }
+   Salida = Incremento;
+   SalidaSaturada = false;
+   PrimeraMuestra = false;
+   ErrorAnterior = ERROR;
+#ifndef CONTROLPID_COMPACTO
+   ProporcionalAnterior = ERROR;
+#endif
+#ifdef CONTROLPID_PERFIL
+   Perfil.Registrar(CiclosTranscurridos(CicloInicial), false, false);
+#endif
+   return Incremento;
+}
+//-------------------------------------------------------------------------------------
+
+boolean controlPID::EnBandaMuerta(float ERROR, float DERIVADA)
+// Indica si ERROR está dentro de la banda muerta: en ese caso no se calcula nada,
+// sólo se actualizan las señales anteriores para no derivar un salto al salir de ella.
+{  if (BandaMuerta==0 || PrimeraMuestra || fabs(ERROR) >= BandaMuerta) return false;
+   ErrorAnterior = ERROR;
+   DerivadaAnterior = DERIVADA;
+   DerivativoAnterior = 0;
+   return true;
+}
+//-------------------------------------------------------------------------------------
+
+void controlPID::IndicarSaturacionExterna(boolean SATURADA)
+// Lo que recibe la salida (un lazo interno, un actuador) está saturado.
+{  SaturacionExterna = SATURADA;
+}
+//-------------------------------------------------------------------------------------
+
+boolean controlPID::EstaSaturada()
+// Indica si la última salida fue recortada (límites o variación) o si lo que la
+// recibe está saturado: en una cascada la saturación del lazo más interno llega
+// así a todos los externos, no sólo al inmediato.
+{  return SalidaSaturada || SaturacionExterna;
+}
+//-------------------------------------------------------------------------------------
+
+boolean controlPID::LimitarVariacion()
+// Indica si la variación de la salida por muestra está limitada.
+{  return VariacionMaxima>0;
+}
+//-------------------------------------------------------------------------------------
+
+boolean controlPID::LimitarVariacion(boolean RESPUESTA, float VARIACION)
+// Limita la variación de la salida entre muestras consecutivas a VARIACION.
+{  VariacionMaxima = (RESPUESTA && VARIACION>0) ? VARIACION : 0;
+   return VariacionMaxima>0;
+}
+//-------------------------------------------------------------------------------------
+
+#ifndef CONTROLPID_COMPACTO
+void controlPID::ConfigurarEventos(float UMBRAL_ERROR, unsigned long INTERVALO_MAXIMO, float UMBRAL_SALIDA)
+{  UmbralEvento = (UMBRAL_ERROR>0) ? UMBRAL_ERROR : 0;
+   UmbralSalida = (UMBRAL_SALIDA>0) ? UMBRAL_SALIDA : 0;
+   IntervaloEvento = INTERVALO_MAXIMO;
+   SalidaInformada = NAN;
+}
+//-------------------------------------------------------------------------------------
+
+boolean controlPID::ControlarPorEvento(float ERROR)
+{  if (Periodo>0) return ControlarPorEvento(ERROR, 0);
+   return ControlarPorEvento(ERROR, micros());
+}
+//-------------------------------------------------------------------------------------
+
+boolean controlPID::ControlarPorEvento(float ERROR, unsigned long TIEMPO)
+// Envío por variación (send-on-delta): sin evento no se llama a Calcular() ni se
+// actualiza TiempoAnterior, así el próximo cálculo integra todo el intervalo.
+// Entre cálculos el error se apartó menos de UmbralEvento del último calculado,
+// de modo que el trapecio sobre el intervalo completo comete un error acotado.
+// Siempre hay un intervalo máximo: sin él un error constante bajo el umbral no
+// integraría nunca y el intervalo de 32 bits desbordaría a los ~71 minutos.
+{  if (Periodo==0 && UmbralEvento>0 && !PrimeraMuestra && fabs(ERROR-ErrorAnterior) <= UmbralEvento) {
+      unsigned long Maximo = IntervaloEvento;
+      // Con margen para la demora de la llamada siguiente: que no se cuente como demora.
+      if (IntervaloMaximo>0 && (Maximo==0 || Maximo>IntervaloMaximo/2)) Maximo = IntervaloMaximo/2;
+      if (Maximo==0) Maximo = EVENTO_MAXIMO;
+      if ((uint32_t)(TIEMPO-TiempoAnterior) < Maximo) return false;
+   }
+   if (Periodo>0) Controlar(ERROR);
+   else Controlar(ERROR, TIEMPO);
+   // SalidaInformada es NAN (distinto de sí mismo) si todavía no se informó ninguna.
+   if (SalidaInformada==SalidaInformada && fabs(Salida-SalidaInformada) <= UmbralSalida) return false;
+   SalidaInformada = Salida;
+   return true;
+}
+//-------------------------------------------------------------------------------------
+#endif
+
+float controlPID::ConfigurarBandaMuerta(float BANDA)
+// Con |ERROR| menor que BANDA, Controlar() devuelve la salida anterior sin calcular.
+// Con BANDA=0 no hay banda muerta.
+{  BandaMuerta = (BANDA>0) ? BANDA : 0;
+   return BandaMuerta;
+}
+//-------------------------------------------------------------------------------------
+
+#ifndef CONTROLPID_COMPACTO
+void controlPID::ConectarTelemetria(colaPID* COLA, uint8_t LAZO)
+// Con COLA=NULL se desconecta.
+{  Telemetria = COLA;
+   LazoTelemetria = LAZO;
+   TiempoTelemetria = 0;
+}
+//-------------------------------------------------------------------------------------
+#endif
+
+float controlPID::FiltrarDerivativo(float N)
+// Filtro de primer orden de la componente derivativa con constante Td/N.
+// Con N=0 no se filtra (equivale a N infinito).
+{  FiltroDerivativo = (N>0) ? N : 0;
+   CalcularCoeficientes();
+   return FiltroDerivativo;
+}
+//-------------------------------------------------------------------------------------
+
+float controlPID::FiltrarDerivativo()
+// Devuelve el N configurado (0 si no se filtra).
+{  return FiltroDerivativo;
+}
+//-------------------------------------------------------------------------------------
+
+void controlPID::LimitarIntervalo(unsigned long MAXIMO, DemoraPID POLITICA)
+// Intervalo máximo entre muestras en microsegundos (0 para no controlarlo)
+// y política ante una demora. No resetea el contador de demoras.
+{  IntervaloMaximo=MAXIMO;
+   PoliticaDemora=(uint8_t)POLITICA;
+}
+//-------------------------------------------------------------------------------------
+
+unsigned long controlPID::ObtenerDemoras()
+{
+   return Demoras;
+}
+//-------------------------------------------------------------------------------------
+
+float controlPID::ObtenerIntegral()
+{
+   return Integral; 
+}
+//-------------------------------------------------------------------------------------
+
+#ifndef CONTROLPID_SIN_TELEMETRIA
+float controlPID::ObtenerProporcional()
+{
+   return Proporcional;
+}
+//-------------------------------------------------------------------------------------
+
+float controlPID::ObtenerDerivativo()
+{
+   return Derivativo;
+}
+//-------------------------------------------------------------------------------------
+#endif
+
+float controlPID::ObtenerSalida()
+{
+   return Salida;
+}
+//-------------------------------------------------------------------------------------
+
+unsigned long controlPID::ObtenerPeriodo()
+{
+   return Periodo;
+}
+//-------------------------------------------------------------------------------------
+
+#ifdef CONTROLPID_PERFIL
+const perfilPID& controlPID::ObtenerPerfil()
+{
+   return Perfil;
+}
+//-------------------------------------------------------------------------------------
+
+void controlPID::ReiniciarPerfil()
+// No se hace en el constructor: con un controlPID global correría antes de init(),
+// que en AVR vuelve a programar Timer1 (preescalador 64, PWM).
+{
+   IniciarContadorCiclos();
+   Perfil.Reiniciar();
+}
+//-------------------------------------------------------------------------------------
+#endif
+
+#ifdef CONTROLPID_INTERVALOS
+const intervalosPID& controlPID::ObtenerIntervalos()
+{
+   return Intervalos;
+}
+//-------------------------------------------------------------------------------------
+
+void controlPID::ReiniciarIntervalos()
+{
+   Intervalos.Reiniciar();
+}
+//-------------------------------------------------------------------------------------
+
+void controlPID::ConfigurarIntervaloObjetivo(unsigned long OBJETIVO, unsigned long TOLERANCIA)
+// Los intervalos mayores que OBJETIVO+TOLERANCIA se cuentan como excesos.
+// Reinicia las estadísticas (OBJETIVO es también la referencia de los desvíos).
+{  Intervalos.Objetivo=OBJETIVO;
+   Intervalos.Tolerancia=TOLERANCIA;
+   Intervalos.Reiniciar();
+}
+//-------------------------------------------------------------------------------------
+#endif
+
+void controlPID::Apagar()
+{
+   TiempoAnterior=0;
+   PrimeraMuestra=true;
+   HaySalidaAnterior=false;
+   ErrorAnterior=0;
+   Integral=0;   
+#ifndef CONTROLPID_COMPACTO
+   SalidaInformada=NAN;
+#endif
+#ifndef CONTROLPID_SIN_TELEMETRIA
+   Proporcional=0;
+   Derivativo=0; 
+#endif
+}
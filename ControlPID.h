@@ -1,72 +1,522 @@
-/****************************************************************************************
-  ControlPID.h
------------------------------------------------------------------------------------------
-  Descripción:
-           Objeto de control PID. 
-           Limita efecto enrole mediante saturación y bloqueo de integración.
------------------------------------------------------------------------------------------
-  Autor:   Guillermo Caporaletti <gfcaporaletti@undav.edu.ar>
-           Sistemas de Control Automático (SCA)
-           Universidad Nacional de Avellaneda (UNDAV)
-  Fecha:   Diciembre 2021
-  Version: 1.0
-****************************************************************************************/
-
-#ifndef CONTROLPID_h
-#define CONTROLPID_h
-#include "Arduino.h"
-
-/***************************************************************************************/
-
-class controlPID                     // Objeto para control Proporcional-Integral-Derivativo (PID)
-{  private:
-      float Salida;                  // La señal de control que va al actuador
-                                     // o potencia de salida (sin asignar unidades)
-      float Proporcional;            // Componente proporcional de la salida (sin asignar unidades)
-      float Integral;                // Componente integral 
-      float Derivativo;              // Componente derivativa
-      float Kp;                      // Constante proporcional (sin asignar unidades)
-      float Ti;                      // Tiempo de integración (en segundos)
-      float Td;                      // Tiempo para la componente derivativa (en segundos)
-      unsigned long TiempoAnterior;  // Tiempo de la medición anterior utilizando micros (en microsegundos)
-      float ErrorAnterior;           // Señal de error anterior 
-      boolean LimitaSalida;          // Indica si establecimos límites superior e inferior a la salida
-      boolean LimitaIntegral;        // Indica si establecimos límites superior e inferior en la integral del PID
-                                     // (en caso true, son los mismos límites que la salida) 
-      boolean CondicionaIntegral;    // Condiciona la ejecución de la integral a que la salida no esté saturada.
-      float SalidaMax;               // Límite superior de la salida (y de la integral)
-      float SalidaMin;               // Límite inferior de la salida
-      const float MILLON=1e6;        // Constante para convertir micros() a segundos.
-      
-   public:
-      controlPID(float KP, float TI, float TD);            // Constructor con lo mínimo:
-                                                           // KP: Constante de proporcionalidad (puede ser negativo)
-                                                           // TI: Tiempo de integración (si es 0, no integra)
-                                                           // TD: Tiempo de derivación (si es 0 no deriva)
-      void ConfigurarPID(float KP, float TI, float TD);    // Mismos parámetros que el constructor.
-                                                           // Sirve para cambiar configuración inicial.
-      boolean LimitarSalida(boolean RESPUESTA, float SMIN, float SMAX);  // Configura los límites de salida.
-                                                           // e indica si están activados.
-      boolean LimitarSalida(boolean RESPUESTA);            // Activa o desactiva los límites de salida
-                                                           // e indica si el límite de salida está activado.
-                                                           // No permite activar límites si antes no fueron establecidos.
-      boolean LimitarSalida();                             // Indica si el límite de salida está activado.
-      boolean LimitarIntegral(boolean RESPUESTA);          // Activa o desactiva el límite de integración
-                                                           // e indica si el límite de integración está activado.
-      boolean LimitarIntegral();                           // Me indica si el límite de integración está activado.
-      boolean CondicionarIntegral(boolean RESPUESTA);      // Activa o desactiva el condicional de integración 
-                                                           // e indica si está activado.
-                                                           // El condicional implicaque no integrará mientras la salida esté saturada.
-      boolean CondicionarIntegral();                       // Me indica si el condicional de integración está activado.
-      float Controlar(float ERROR);                        // Calcula señal de control (salida) en función del error.
-      void Apagar();                                       // Apaga el PID y resetea valores.
-                                                           // No se modifican los valores de KP, TI y TD.
-                                                           // Tampoco los límites pre establecidos.
-      float ObtenerIntegral(); 
-      float ObtenerProporcional(); 
-      float ObtenerDerivativo(); 
-      float ObtenerSalida();
-};
-
-/***************************************************************************************/
-
+/****************************************************************************************
+  ControlPID.h
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Objeto de control PID. 
+           Limita efecto enrole mediante saturación y bloqueo de integración.
+-----------------------------------------------------------------------------------------
+  Perfil:
+           Definiendo CONTROLPID_PERFIL al compilar (en todo el proyecto) cada llamada
+           a Controlar() mide sus ciclos de reloj (salvo las que caen en la banda
+           muerta, que no calculan). Hay que llamar a ReiniciarPerfil() desde setup()
+           antes de medir: inicia el contador de ciclos (en AVR toma Timer1). Ver
+           ControlPIDPerfil.h.
+           Definiendo CONTROLPID_INTERVALOS se lleva la estadística de los intervalos
+           entre muestras (jitter). Con período fijo, Controlar(ERROR) no mide el tiempo
+           y no actualiza esa estadística.
+-----------------------------------------------------------------------------------------
+  Concurrencia:
+           Con CONTROLPID_CONCURRENTE (por omisión en ESP32 y RP2040) las constantes y
+           los límites se pueden cambiar desde otro núcleo con PublicarPID(),
+           PublicarLimitarSalida() y demás mientras se ejecuta Controlar(), sin mutex
+           (seqlock: un contador par/impar indica si el bloque publicado está completo).
+-----------------------------------------------------------------------------------------
+  Memoria:
+           Definiendo CONTROLPID_SIN_TELEMETRIA al compilar (en todo el proyecto, no
+           sólo en el sketch) no se guardan las componentes proporcional y derivativa
+           ni existen ObtenerProporcional() y ObtenerDerivativo().
+           Definiendo CONTROLPID_COMPACTO (también en todo el proyecto) se quitan las
+           funciones que más memoria ocupan por instancia: modo por eventos,
+           prealimentación, pesos de la referencia (ControlarReferencia() usa b=c=1),
+           tabla de ganancias y cola de telemetría. Para muchos lazos en poca RAM
+           (16 lazos compactos en un Uno ocupan 1.6 de sus 2 KB).
+           sizeof(controlPID) en bytes:
+                                               AVR   ARM/ESP32
+              Versión 1.0                       51      52
+              Con período fijo, flags boolean   64      68
+              Flags en campos de bits           57      60
+              CONTROLPID_SIN_TELEMETRIA         49      52
+              Filtro derivativo (+16 bytes)     73      76
+              Retrocálculo, incremental (+12)   85      88
+              Variación, banda muerta (+8)      93      96
+              Demoras: CONTROLPID_COMPACTO     102     104
+                con CONTROLPID_SIN_TELEMETRIA   94      96
+              Completo                         147     160
+                con CONTROLPID_SIN_TELEMETRIA  139     152
+           Lo que agrega el completo al compacto:
+              Eventos                           16      16
+              Prealimentación (valor, función)   6       8
+              Pesos b, c y su señal anterior    12      12
+              Tabla de ganancias                 4       8
+              Cola de telemetría (con tiempo)    7      12
+           Se suman CONTROLPID_PERFIL, CONTROLPID_INTERVALOS y CONTROLPID_CONCURRENTE si
+           se definen (ver ControlPIDPerfil.h).
+-----------------------------------------------------------------------------------------
+  Precisión:
+           Con Ti grande y período corto cada incremento de la integral es tan chico
+           frente a ella que, en float, se redondea a cero y la integral deja de
+           avanzar. Definiendo CONTROLPID_ACUMULADOR=double al compilar (en todo el
+           proyecto) la integral se acumula en double; entradas, salidas y constantes
+           siguen en float. Le sirve a Cortex-M7 y a la PC (en ESP32 y Cortex-M4 double
+           se emula por software; medir con extras/host/rendimiento_doble). En AVR
+           double es float y no cambia nada. estadoPID y la telemetría guardan la
+           integral en float (se redondea al guardarla).
+           Para elegir el tipo de cada lazo usar controlPIDT<..., ESCALAR, ACUMULADOR>.
+-----------------------------------------------------------------------------------------
+  Autor:   Guillermo Caporaletti <gfcaporaletti@undav.edu.ar>
+           Sistemas de Control Automático (SCA)
+           Universidad Nacional de Avellaneda (UNDAV)
+  Fecha:   Diciembre 2021
+  Version: 1.0
+****************************************************************************************/
+
+#ifndef CONTROLPID_h
+#define CONTROLPID_h
+#include "Arduino.h"
+#if defined(CONTROLPID_PERFIL) || defined(CONTROLPID_INTERVALOS)
+#include "ControlPIDPerfil.h"
+#endif
+#if !defined(CONTROLPID_CONCURRENTE) && (defined(ESP32) || defined(ARDUINO_ARCH_RP2040))
+#define CONTROLPID_CONCURRENTE       // Doble núcleo: se habilita PublicarPID()
+#endif
+
+/***************************************************************************************/
+
+#if defined(__AVR__)
+typedef uint8_t secuenciaPID;        // Contador de publicaciones: su lectura debe ser atómica
+#else
+typedef uint32_t secuenciaPID;
+#endif
+
+/***************************************************************************************/
+
+inline void BarreraPID()
+// Impide que el compilador y el procesador reordenen accesos a memoria a través de ella.
+{
+#if defined(__AVR__)
+   __asm__ __volatile__("" ::: "memory");  // Un solo núcleo: alcanza con el compilador
+#else
+   __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+}
+
+class colaPID;                       // Cola de telemetría (ControlPIDTelemetria.h)
+
+#ifndef CONTROLPID_ACUMULADOR
+#define CONTROLPID_ACUMULADOR float
+#endif
+typedef CONTROLPID_ACUMULADOR acumuladorPID;  // Tipo de la integral (ver "Precisión")
+
+/***************************************************************************************/
+
+enum class DemoraPID : uint8_t       // Qué hacer si el intervalo entre muestras supera el máximo
+{  Recortar,                         // Integra y deriva como si hubiera pasado el intervalo máximo
+   Resincronizar,                    // Descarta el intervalo: no integra ni deriva en esa muestra
+   Apagar                            // Resetea el PID (como Apagar())
+};
+
+/***************************************************************************************/
+
+enum class DiscretizacionPID : uint8_t  // Aproximación discreta de la integral y de la derivativa
+{  Tustin,                           // Trapezoidal (por omisión para la integral; la derivativa
+                                     // sin filtro tendría un polo en z=-1: usa EulerAtras)
+   EulerAtras,                       // Diferencia hacia atrás (por omisión para la derivativa)
+   EulerAdelante,                    // Diferencia hacia adelante (la derivativa necesita filtro
+                                     // y es inestable si Ts >= 2*Tf: en ese caso usa EulerAtras)
+   TustinPrecompensado               // Tustin con precompensación en el polo del filtro 1/Tf
+                                     // (si Ts >= pi*Tf no hay precompensación posible y usa
+                                     // Tustin; en la integral equivale a Tustin)
+};
+
+struct coeficientesPID               // Ecuación en diferencias del PID con período fijo:
+{  float B0, B1, B2;                 // u[n] = B0*e[n] + B1*e[n-1] + B2*e[n-2]
+   float A1, A2;                     //      + A1*u[n-1] + A2*u[n-2]
+};                                   // (signos de A como en arm_biquad_cascade_df1_f32; con
+                                     // A1=1 y A2=0 B0..B2 son los A0..A2 de arm_pid_f32)
+
+/***************************************************************************************/
+
+struct puntoGananciaPID              // Punto de una tabla de ganancias
+{  float Variable;                   // Valor de la variable de planificación
+   float Kp;                         // Constantes del PID en ese punto
+   float Ti;
+   float Td;
+};
+
+/***************************************************************************************/
+
+struct estadoPID                     // Estado completo de un controlPID, para guardarlo (EEPROM,
+{                                    // RAM del RTC, NVS) y restaurarlo tras un reinicio.
+   uint16_t Version;                 // VERSION_ESTADOPID al guardarlo
+   uint16_t Tamano;                  // sizeof(estadoPID) al guardarlo
+   float Kp, Ti, Td;                 // Constantes
+   float SalidaMax, SalidaMin;       // Límites de salida
+   float Integral;                   // Punto de operación (sin las señales anteriores: tras
+   float Salida;                     // restaurar, la primera muestra no integra ni deriva)
+   float Prealimentacion;            // Prealimentación fija (la función de ConfigurarPrealimentacion()
+                                     // no se guarda: es una dirección del programa)
+   uint32_t Periodo;                 // Período fijo (0 si se mide)
+   uint32_t IntervaloMaximo;
+   float FiltroDerivativo;           // N del filtro derivativo
+   float TiempoSeguimiento;          // Tt del retrocálculo
+   float VariacionMaxima;
+   float BandaMuerta;
+   float PesoProporcional;           // b y c de la referencia ponderada
+   float PesoDerivativo;
+   float UmbralEvento;               // Modo por eventos (ConfigurarEventos())
+   float UmbralSalida;
+   uint32_t IntervaloEvento;
+   uint8_t Opciones;                 // Flags (bits OPCION_*)
+   uint8_t Discretizacion;           // Integral | derivativa<<2 | DISCRETIZACION_GUARDADA
+   uint16_t Crc;                     // CrcPID() de todo lo anterior
+
+   static constexpr uint16_t VERSION_ESTADOPID = 4;
+   static constexpr uint8_t OPCION_LIMITA_SALIDA = 0x01;
+   static constexpr uint8_t OPCION_LIMITA_INTEGRAL = 0x02;
+   static constexpr uint8_t OPCION_CONDICIONA_INTEGRAL = 0x04;
+   static constexpr uint8_t OPCION_SIN_SALTO = 0x08;
+   static constexpr uint8_t OPCION_POLITICA_DEMORA = 0x30;  // Dos bits: DemoraPID
+   static constexpr uint8_t DISCRETIZACION_GUARDADA = 0x80; // Sin este bit (estados anteriores): por omisión
+};
+
+uint16_t CrcPID(const void* DATOS, size_t BYTES, uint16_t CRC = 0xFFFF);
+                                     // CRC-16/CCITT (polinomio 0x1021). Encadenable pasando
+                                     // el CRC anterior.
+
+/***************************************************************************************/
+
+class controlPID                     // Objeto para control Proporcional-Integral-Derivativo (PID)
+{  private:
+      float Salida;                  // La señal de control que va al actuador
+                                     // o potencia de salida (sin asignar unidades)
+#ifndef CONTROLPID_SIN_TELEMETRIA
+      float Proporcional;            // Componente proporcional de la salida (sin asignar unidades)
+#endif
+      acumuladorPID Integral;        // Componente integral
+#ifndef CONTROLPID_SIN_TELEMETRIA
+      float Derivativo;              // Componente derivativa
+#endif
+      float Kp;                      // Constante proporcional (sin asignar unidades)
+      float Ti;                      // Tiempo de integración (en segundos)
+      float Td;                      // Tiempo para la componente derivativa (en segundos)
+      unsigned long TiempoAnterior;  // Tiempo de la medición anterior utilizando micros (en microsegundos)
+      float ErrorAnterior;           // Señal de error anterior 
+#ifndef CONTROLPID_COMPACTO
+      float ProporcionalAnterior;    // Señal de la proporcional anterior (el error, o b*r-y)
+#endif
+      float SalidaMax;               // Límite superior de la salida (y de la integral)
+      float SalidaMin;               // Límite inferior de la salida
+      unsigned long Periodo;         // Período de muestreo fijo (en microsegundos)
+                                     // Si es 0, el período se mide con micros() en cada llamada.
+      float CoefIntegral;            // Kp*Ts/(2*Ti), precalculado para período fijo
+      float CoefDerivativo;          // Kp*Td/(Tf+Ts), precalculado para período fijo (o Bd, ver Derivar())
+      float FiltroDerivativo;        // N del filtro derivativo Tf=Td/N (0 si no se filtra)
+      float TiempoFiltro;            // Tf (en microsegundos)
+      float CoefFiltro;              // Ts/(Tf+Ts), precalculado para período fijo (o Ad, ver Derivar())
+      float DerivadaAnterior;        // Señal que se deriva, filtrada, de la muestra anterior
+      float TiempoSeguimiento;       // Tt del retrocálculo de la integral (en segundos, 0 si no se usa)
+      float CoefSeguimiento;         // Ts/Tt, precalculado para período fijo
+      float DerivativoAnterior;      // Componente derivativa anterior
+      float VariacionMaxima;         // Variación máxima de la salida por muestra (0 si no se limita)
+      float BandaMuerta;             // Con |error| menor no se calcula (0 si no hay banda muerta)
+#ifndef CONTROLPID_COMPACTO
+      float UmbralEvento;            // Variación del error que dispara un cálculo (0: siempre calcula)
+      float UmbralSalida;            // Variación de la salida que se informa como cambio
+      float SalidaInformada;         // Última salida informada por ControlarPorEvento() (NAN: ninguna)
+      unsigned long IntervaloEvento; // Tiempo máximo sin calcular (en microsegundos, 0: por omisión)
+      float Prealimentacion;         // Término que se suma a la salida (prealimentación fija)
+      float PesoProporcional;        // b: peso de la referencia en la proporcional
+      float PesoDerivativo;          // c: peso de la referencia en la derivativa
+      float (*FuncionPrealimentacion)();  // Si no es NULL, da la prealimentación en cada muestra
+#endif
+      boolean EnBandaMuerta(float ERROR, float DERIVADA);  // Verifica la banda muerta (y actualiza lo anterior).
+      unsigned long IntervaloMaximo; // Intervalo máximo entre muestras (0 si no se controla)
+      unsigned long Demoras;         // Cantidad de intervalos que superaron el máximo
+      boolean LimitaSalida : 1;      // Indica si establecimos límites superior e inferior a la salida
+      boolean LimitaIntegral : 1;    // Indica si establecimos límites superior e inferior en la integral del PID
+                                     // (en caso true, son los mismos límites que la salida) 
+      boolean CondicionaIntegral : 1;  // Condiciona la ejecución de la integral a que la salida no esté saturada.
+      boolean PrimeraMuestra : 1;    // Indica que no hay muestra anterior (no integra ni deriva)
+      boolean HaySalidaAnterior : 1; // Salida es válida para limitar la variación (sólo Apagar() la borra)
+      uint8_t PoliticaDemora : 2;    // DemoraPID a aplicar cuando se supera IntervaloMaximo
+      boolean SinSalto : 1;          // Al cambiar constantes se conserva la integral (sin salto en la salida)
+      boolean SaturacionExterna : 1; // Lo que sigue a la salida está saturado (bloquea la integral)
+      boolean SalidaSaturada : 1;    // La última salida fue recortada
+      uint8_t DiscretizacionIntegral : 2;    // DiscretizacionPID de la integral
+      uint8_t DiscretizacionDerivativo : 2;  // DiscretizacionPID de la derivativa
+      static constexpr float MILLON=1e6;  // Constante para convertir micros() a segundos.
+#ifndef CONTROLPID_COMPACTO
+      static constexpr unsigned long EVENTO_MAXIMO=60000000UL;  // Intervalo máximo por eventos por omisión (1 minuto)
+#endif
+#ifdef CONTROLPID_PERFIL
+      perfilPID Perfil;              // Ciclos por llamada y contadores de saturación
+#endif
+#ifdef CONTROLPID_INTERVALOS
+      intervalosPID Intervalos;      // Estadística de los intervalos entre muestras
+#endif
+#ifdef CONTROLPID_CONCURRENTE
+      volatile secuenciaPID Secuencia;    // Contador de publicaciones (impar: escritura en curso)
+      secuenciaPID SecuenciaAplicada;     // Última publicación aplicada por Controlar()
+      volatile float KpPublicado;    // Constantes publicadas por PublicarPID()
+      volatile float TiPublicado;
+      volatile float TdPublicado;
+      volatile float SalidaMinPublicada;  // Límites publicados por PublicarLimitarSalida()
+      volatile float SalidaMaxPublicada;
+      volatile uint8_t OpcionesPublicadas;  // Bit (1<<grupo): opción publicada de cada grupo
+      enum { PUBLICA_CONSTANTES, PUBLICA_SALIDA, PUBLICA_INTEGRAL, PUBLICA_CONDICIONAL, GRUPOS_PUBLICADOS };
+      volatile uint8_t Publicaciones[GRUPOS_PUBLICADOS];  // Publicaciones de cada grupo
+      uint8_t Aplicaciones[GRUPOS_PUBLICADOS];            // Publicaciones de cada grupo ya aplicadas
+      void IniciarPublicacion();     // Escritor: pasa Secuencia a impar...
+      void TerminarPublicacion();    // ...y de nuevo a par, con el bloque completo.
+      void LeerPublicacion();        // Aplica lo publicado, si se leyó entero.
+#endif
+      float Calcular(float ERROR, float PROPORCIONAL, float DERIVADA, unsigned long INTERVALO);
+                                     // Cálculo del PID (común a todos los Controlar).
+      unsigned long MedirIntervalo(unsigned long TIEMPO);  // Intervalo desde TiempoAnterior (y lo actualiza).
+      unsigned long RevisarDemora(unsigned long INTERVALO);  // Aplica PoliticaDemora si corresponde.
+      float Derivar(float DERIVADA, unsigned long INTERVALO, boolean HAY_MUESTRA);
+                                     // Componente derivativa (con filtro). Actualiza DerivadaAnterior.
+      void CoeficientesDerivativo(float TS, float& AD, float& BD);
+                                     // D[n] = AD*D[n-1] + BD*(x[n]-x[n-1]) con período TS (en segundos).
+      float SumaIntegral(float ERROR);   // Errores que se integran, por 2 (trapecio: ERROR+ErrorAnterior).
+      float CalcularIncremento(float ERROR, unsigned long INTERVALO);  // Cálculo de ControlarIncremental.
+      void AplicarPID(float KP, float TI, float TD, boolean SIN_SALTO);
+                                                           // Cambia las constantes, sin salto o reseteando.
+      void CalcularCoeficientes();   // Calcula los coeficientes discretos para período fijo.
+#ifndef CONTROLPID_COMPACTO
+      const puntoGananciaPID* TablaGanancias;  // Tabla de ganancias en memoria de programa (PROGMEM)
+      uint8_t CantidadGanancias;     // Cantidad de puntos de la tabla
+      uint8_t SegmentoGanancias;     // Último segmento usado (búsqueda rápida si no cambió)
+      colaPID* Telemetria;           // Cola donde se registra cada muestra (NULL si no hay)
+      uint8_t LazoTelemetria;        // Número de lazo que se anota en cada registro
+      uint32_t TiempoTelemetria;     // Tiempo del lazo para la telemetría: suma de los intervalos
+                                     // sin recortar, incluidas las muestras en la banda muerta
+#endif
+      
+   public:
+      controlPID(float KP, float TI, float TD);            // Constructor con lo mínimo:
+                                                           // KP: Constante de proporcionalidad (puede ser negativo)
+                                                           // TI: Tiempo de integración (si es 0, no integra)
+                                                           // TD: Tiempo de derivación (si es 0 no deriva)
+      void ConfigurarPID(float KP, float TI, float TD);    // Mismos parámetros que el constructor.
+                                                           // Sirve para cambiar configuración inicial.
+#ifdef CONTROLPID_CONCURRENTE
+      void PublicarPID(float KP, float TI, float TD);      // Publica nuevas constantes desde otro núcleo o tarea,
+                                                           // sin bloquear: Controlar() las toma al comienzo de
+                                                           // la próxima muestra. Admite un único escritor.
+      void PublicarLimitarSalida(boolean RESPUESTA, float SMIN, float SMAX);
+      void PublicarLimitarIntegral(boolean RESPUESTA);     // Ídem para LimitarSalida(), LimitarIntegral() y
+      void PublicarCondicionarIntegral(boolean RESPUESTA); // CondicionarIntegral(): cada publicación se aplica
+                                                           // una vez, en el orden de esta lista. El mismo
+                                                           // escritor único que PublicarPID().
+#endif
+      boolean TransferenciaSinSalto(boolean RESPUESTA);    // Indica si las constantes publicadas conservan la
+                                                           // integral, compensándola para que la salida no salte.
+                                                           // (ConfigurarPID() siempre resetea la integral.)
+      boolean TransferenciaSinSalto();                     // Indica si la transferencia sin salto está activada.
+#ifndef CONTROLPID_COMPACTO
+      boolean ConfigurarTablaGanancias(const puntoGananciaPID* TABLA, uint8_t CANTIDAD);
+                                                           // Tabla de ganancias (en PROGMEM) ordenada de menor a
+                                                           // mayor Variable. Con CANTIDAD=0 (o TABLA=NULL) se quita.
+      void PlanificarGanancias(float VARIABLE);            // Interpola Kp, Ti y Td de la tabla en VARIABLE
+                                                           // y los aplica sin salto en la salida. Fuera de la
+                                                           // tabla usa el primer o último punto. Si las
+                                                           // constantes no cambian no recalcula nada.
+#endif
+      void ConfigurarPeriodo(unsigned long PERIODO);       // Establece un período de muestreo fijo (en microsegundos).
+                                                           // Los coeficientes discretos se calculan una vez y
+                                                           // Controlar() sólo multiplica y suma (no llama a micros()).
+                                                           // Se debe llamar a Controlar() cada PERIODO.
+                                                           // Con PERIODO=0 vuelve a medir el tiempo con micros().
+      boolean LimitarSalida(boolean RESPUESTA, float SMIN, float SMAX);  // Configura los límites de salida.
+                                                           // e indica si están activados.
+      boolean LimitarSalida(boolean RESPUESTA);            // Activa o desactiva los límites de salida
+                                                           // e indica si el límite de salida está activado.
+                                                           // No permite activar límites si antes no fueron establecidos.
+      boolean LimitarSalida();                             // Indica si el límite de salida está activado.
+      boolean LimitarIntegral(boolean RESPUESTA);          // Activa o desactiva el límite de integración
+                                                           // e indica si el límite de integración está activado.
+      boolean LimitarIntegral();                           // Me indica si el límite de integración está activado.
+      boolean CondicionarIntegral(boolean RESPUESTA);      // Activa o desactiva el condicional de integración 
+                                                           // e indica si está activado.
+                                                           // El condicional implicaque no integrará mientras la salida esté saturada.
+      boolean CondicionarIntegral();                       // Me indica si el condicional de integración está activado.
+      boolean LimitarVariacion(boolean RESPUESTA, float VARIACION);
+                                                           // Activa o desactiva el límite de variación de la salida
+                                                           // (máximo cambio por muestra, en unidades de la salida)
+                                                           // e indica si está activado. Mientras limita, la salida
+                                                           // cuenta como saturada: el condicional y el retrocálculo
+                                                           // de la integral también actúan. También limita la
+                                                           // primera muestra tras reconfigurar (ConfigurarPID(),
+                                                           // ConfigurarPeriodo(), RestaurarEstado(), una demora):
+                                                           // sólo tras Apagar() la salida parte libre.
+      boolean LimitarVariacion();                          // Me indica si la variación está limitada.
+      void IndicarSaturacionExterna(boolean SATURADA);     // Indica que lo que recibe la salida (el lazo interno de
+                                                           // una cascada, un actuador con su propio límite) está
+                                                           // saturado: con CondicionarIntegral no se integra.
+                                                           // Vale hasta que se indique lo contrario.
+      boolean EstaSaturada();                              // Indica si la última salida fue recortada por los
+                                                           // límites o por el límite de variación, o si hay
+                                                           // saturación externa (IndicarSaturacionExterna()).
+      float ConfigurarBandaMuerta(float BANDA);            // Con |ERROR| < BANDA, Controlar() devuelve la salida
+                                                           // anterior sin calcular (ni integrar).
+                                                           // ControlarIncremental() devuelve 0.
+                                                           // Con BANDA=0 no hay banda muerta.
+#ifndef CONTROLPID_COMPACTO
+      void ConfigurarEventos(float UMBRAL_ERROR, unsigned long INTERVALO_MAXIMO, float UMBRAL_SALIDA = 0);
+                                                           // Modo por eventos (ver ControlarPorEvento()): sólo se
+                                                           // calcula si el error cambió más de UMBRAL_ERROR desde
+                                                           // el último cálculo o pasaron INTERVALO_MAXIMO
+                                                           // microsegundos. Se limita a la mitad del máximo de
+                                                           // LimitarIntervalo() (para que no cuente como demora);
+                                                           // con 0 se usa esa mitad o, sin LimitarIntervalo(),
+                                                           // 1 minuto. No hay "sin máximo": un error constante
+                                                           // bajo el umbral no integraría nunca. Más largo ahorra
+                                                           // cálculos pero demora la acción integral ante errores
+                                                           // chicos. Con UMBRAL_ERROR=0 se calcula siempre.
+      boolean ControlarPorEvento(float ERROR);             // Ídem Controlar(ERROR), salvo que, sin evento, no calcula.
+                                                           // Devuelve true si la salida (ObtenerSalida()) cambió más
+                                                           // de UMBRAL_SALIDA desde la última vez que devolvió true:
+                                                           // sólo entonces hace falta escribir el actuador.
+                                                           // La integral usa el intervalo desde el último cálculo,
+                                                           // de modo que no se pierde lo no calculado. Requiere medir
+                                                           // el tiempo: con período fijo calcula en cada llamada.
+      boolean ControlarPorEvento(float ERROR, unsigned long TIEMPO);
+#endif
+      boolean RetrocalcularIntegral(boolean RESPUESTA, float TT);
+                                                           // Activa o desactiva el retrocálculo de la integral
+                                                           // e indica si está activado: mientras la salida esté
+                                                           // saturada, la integral se corrige con
+                                                           // (salida saturada - salida calculada)*dt/TT.
+                                                           // TT (en segundos) suele elegirse entre Td y Ti.
+                                                           // Deben haberse preestablecido los límites de salida.
+      boolean RetrocalcularIntegral();                     // Me indica si el retrocálculo está activado.
+      float Controlar(float ERROR);                        // Calcula señal de control (salida) en función del error.
+                                                           // Toma el tiempo con micros() (salvo con período fijo).
+      float Controlar(float ERROR, unsigned long TIEMPO);  // Ídem, con el tiempo actual TIEMPO (en microsegundos)
+                                                           // provisto por quien llama. Permite compartir una misma
+                                                           // medición de tiempo entre varios PID.
+      float ControlarIntervalo(float ERROR, unsigned long INTERVALO);
+                                                           // Ídem, con el intervalo desde la muestra anterior
+                                                           // (en microsegundos) ya calculado.
+                                                           // Con período fijo, INTERVALO no se utiliza.
+      float ControlarReferencia(float REFERENCIA, float MEDICION);
+                                                           // PID de dos grados de libertad: recibe referencia y
+                                                           // medición por separado. Integra el error REFERENCIA-
+                                                           // MEDICION; la proporcional actúa sobre b*REFERENCIA-
+                                                           // MEDICION y la derivativa sobre c*REFERENCIA-MEDICION
+                                                           // (ver PonderarReferencia()). Con b=c=1 es Controlar(ERROR).
+                                                           // Con CONTROLPID_COMPACTO no hay pesos: b=c=1.
+      float ControlarReferencia(float REFERENCIA, float MEDICION, unsigned long TIEMPO);
+                                                           // Ídem, con el tiempo actual TIEMPO (en microsegundos).
+#ifndef CONTROLPID_COMPACTO
+      void PonderarReferencia(float B, float C);           // Pesos de la referencia en la proporcional (B) y la
+                                                           // derivativa (C), entre 0 y 1. Con B<1 un salto de la
+                                                           // referencia da menos sobrepico sin perder rechazo de
+                                                           // perturbaciones; con C=0 no produce pico derivativo.
+                                                           // Por omisión B=C=1.
+#endif
+      float ControlarMedicion(float ERROR, float MEDICION);
+                                                           // Ídem Controlar(ERROR), pero la componente derivativa
+                                                           // actúa sobre la medición (la variable del proceso) y no
+                                                           // sobre el error: un salto de la referencia no produce
+                                                           // un pico en la salida. Con referencia constante da lo
+                                                           // mismo que Controlar(). No conviene alternar ambos.
+      float ControlarMedicion(float ERROR, float MEDICION, unsigned long TIEMPO);
+#ifndef CONTROLPID_COMPACTO
+      float ControlarPrealimentado(float ERROR, float PREALIMENTACION);
+                                                           // Ídem Controlar(ERROR), sumando PREALIMENTACION (lo que
+                                                           // necesita el actuador según la referencia o una
+                                                           // perturbación medida) antes de saturar: los límites,
+                                                           // el condicional y el retrocálculo ven la suma y la
+                                                           // integral sólo corrige lo que falta.
+                                                           // El valor queda fijo para las muestras siguientes.
+      float ControlarPrealimentado(float ERROR, float PREALIMENTACION, unsigned long TIEMPO);
+                                                           // Ídem, con el tiempo actual TIEMPO (en microsegundos).
+      void FijarPrealimentacion(float PREALIMENTACION);    // Prealimentación fija para todas las formas de Controlar()
+                                                           // (0 para quitarla). No se aplica a ControlarIncremental().
+      void ConfigurarPrealimentacion(float (*FUNCION)());  // Función que se llama en cada muestra y devuelve la
+                                                           // prealimentación (por ejemplo, a partir de la perturbación
+                                                           // medida). Tiene prioridad sobre el valor fijo.
+                                                           // Con NULL se vuelve al valor fijo.
+#endif
+      float ControlarIncremental(float ERROR);             // Forma de velocidad: devuelve el incremento de la señal
+                                                           // de control (para posicionadores o motores paso a paso
+                                                           // que reciben cambios y no valores absolutos).
+                                                           // Sin integral acumulada no hay enrole; no se aplican
+                                                           // LimitarSalida ni el anti-enrole. La primera muestra
+                                                           // devuelve 0. ObtenerSalida() da el último incremento.
+                                                           // No conviene alternarlo con Controlar().
+      float ControlarIncremental(float ERROR, unsigned long TIEMPO);
+                                                           // Ídem, con el tiempo actual TIEMPO (en microsegundos).
+#ifndef CONTROLPID_COMPACTO
+      void ConectarTelemetria(colaPID* COLA, uint8_t LAZO = 0);
+                                                           // Cada Controlar() agrega a COLA un registro binario con
+                                                           // tiempo, error, componentes, salida e indicadores de
+                                                           // saturación, para leerlos luego en bloque desde loop().
+                                                           // LAZO identifica al PID si varios comparten la cola.
+                                                           // No registra ControlarIncremental() ni las muestras en
+                                                           // la banda muerta (pero su tiempo cuenta en el registro
+                                                           // siguiente). Con COLA=NULL se desconecta.
+                                                           // El tiempo de cada registro es el del lazo (desde que
+                                                           // se conectó), no el de la cola.
+#endif
+      float FiltrarDerivativo(float N);                    // Filtra la componente derivativa con un pasabajos de
+                                                           // primer orden de constante Td/N (típico: N entre 3 y 20)
+                                                           // para no amplificar el ruido de la medición.
+                                                           // Con N=0 no se filtra. Devuelve el N configurado.
+      float FiltrarDerivativo();                           // Devuelve el N configurado (0 si no se filtra).
+      void ConfigurarDiscretizacion(DiscretizacionPID INTEGRAL, DiscretizacionPID DERIVATIVO);
+                                                           // Aproximación discreta de cada acción (por omisión
+                                                           // Tustin y EulerAtras). La próxima muestra no integra
+                                                           // ni deriva. ControlarIncremental() integra siempre
+                                                           // con EulerAtras.
+      boolean ObtenerCoeficientes(coeficientesPID& COEFICIENTES);
+                                                           // Ecuación en diferencias equivalente (período fijo,
+                                                           // salida sin saturar, sin pesos de referencia ni
+                                                           // prealimentación), para ejecutarla en un núcleo de
+                                                           // biquad o arm_pid. Devuelve false sin período fijo.
+      void LimitarIntervalo(unsigned long MAXIMO, DemoraPID POLITICA);
+                                                           // Establece el intervalo máximo esperable entre muestras
+                                                           // (en microsegundos) y qué hacer si se supera (demora).
+                                                           // Con MAXIMO=0 no se controla el intervalo.
+      unsigned long ObtenerDemoras();                      // Cantidad de demoras detectadas.
+      void Apagar();                                       // Apaga el PID y resetea valores.
+                                                           // No se modifican los valores de KP, TI y TD.
+                                                           // Tampoco los límites pre establecidos.
+      float ObtenerIntegral(); 
+#ifndef CONTROLPID_SIN_TELEMETRIA
+      float ObtenerProporcional(); 
+      float ObtenerDerivativo(); 
+#endif
+      float ObtenerSalida();
+      void GuardarEstado(estadoPID& ESTADO);               // Copia constantes, límites, opciones, el modo por
+                                                           // eventos y el punto de operación (integral, salida,
+                                                           // prealimentación fija) en ESTADO, con su CRC.
+      boolean RestaurarEstado(const estadoPID& ESTADO);    // Restaura un estado guardado. Si la versión, el tamaño
+                                                           // o el CRC no coinciden, o algún campo está fuera de
+                                                           // rango, devuelve false y no cambia nada.
+                                                           // La próxima muestra no deriva (el tiempo anterior no se
+                                                           // conserva) pero parte de la integral guardada.
+      unsigned long ObtenerPeriodo();                      // Período fijo configurado (0 si se mide con micros()).
+#ifdef CONTROLPID_PERFIL
+      const perfilPID& ObtenerPerfil();                    // Ciclos de reloj por llamada (mín/máx/promedio),
+                                                           // salidas saturadas e integrales bloqueadas.
+                                                           // No incluye la lectura de micros().
+      void ReiniciarPerfil();                              // Inicia el contador de ciclos y pone en cero las
+                                                           // estadísticas. Llamarla desde setup(), no antes
+                                                           // (en AVR reconfigura Timer1: ver ControlPIDPerfil.h).
+#endif
+#ifdef CONTROLPID_INTERVALOS
+      const intervalosPID& ObtenerIntervalos();            // Media, desvío, mín/máx y excesos de los
+                                                           // intervalos entre muestras (jitter).
+      void ReiniciarIntervalos();                          // Pone en cero las estadísticas.
+      void ConfigurarIntervaloObjetivo(unsigned long OBJETIVO, unsigned long TOLERANCIA);
+                                                           // Período esperado y tolerancia (en microsegundos):
+                                                           // cuenta los intervalos mayores que OBJETIVO+TOLERANCIA.
+#endif
+};
+
+/***************************************************************************************/
+
+#endif
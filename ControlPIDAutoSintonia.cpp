@@ -0,0 +1,136 @@
+/***********************************************************************************
+  ControlPIDAutoSintonia.cpp
+-----------------------------------------------------------------------------------
+  Descripción:
+           Sintonía automática de controlPID por el método del relé.
+-----------------------------------------------------------------------------------
+  Autor:   Colaboradores de ControlPID, sobre la biblioteca original de
+           Guillermo Caporaletti <gfcaporaletti@undav.edu.ar>
+           Sistemas de Control Automático (SCA)
+           Universidad Nacional de Avellaneda (UNDAV)
+  Fecha:   Octubre 2026
+  Version: 1.1
+***********************************************************************************/
+
+#include "Arduino.h"
+#include "ControlPIDAutoSintonia.h"
+
+/**************************************************************************************/
+
+autoSintoniaPID::autoSintoniaPID(controlPID* PID_)
+{  PID=PID_;
+   Estado=EstadoSintonia::Inactiva;
+   DuracionMaxima=0;
+   GananciaCritica=0;
+   PeriodoCritico=0;
+}
+//-------------------------------------------------------------------------------------
+
+void autoSintoniaPID::Iniciar(float CENTRO, float AMPLITUD, float HISTERESIS, ReglaSintonia REGLA, uint8_t CICLOS)
+{  Centro=CENTRO;
+   Amplitud=AMPLITUD;
+   Histeresis=fabs(HISTERESIS);
+   Regla=REGLA;
+   CiclosPedidos=(CICLOS>0) ? CICLOS : 1;
+   Ciclos=0;
+   ReleAlto=true;
+   HayMuestra=false;
+   DesdeCambio=0;
+   Maximo=-1e30;
+   Minimo=1e30;
+   SumaPeriodos=0;
+   SumaAmplitudes=0;
+   GananciaCritica=0;
+   PeriodoCritico=0;
+   PID->Apagar();                            // Al volver, el PID arranca de una primera muestra
+   Estado=EstadoSintonia::EnCurso;
+}
+//-------------------------------------------------------------------------------------
+
+void autoSintoniaPID::LimitarDuracion(unsigned long MAXIMO)
+{  DuracionMaxima=MAXIMO;
+}
+//-------------------------------------------------------------------------------------
+
+float autoSintoniaPID::Controlar(float ERROR)
+{  return Controlar(ERROR, micros());
+}
+//-------------------------------------------------------------------------------------
+
+float autoSintoniaPID::Controlar(float ERROR, unsigned long TIEMPO)
+// Relé con histéresis: pasa a alto cuando el error supera +HISTERESIS y a bajo
+// cuando baja de -HISTERESIS. Cada paso a alto cierra un ciclo.
+{  if (Estado!=EstadoSintonia::EnCurso) return PID->Controlar(ERROR, TIEMPO);
+   if (HayMuestra) DesdeCambio += (uint32_t)(TIEMPO-TiempoAnterior);  // Correcto aunque micros() desborde
+   HayMuestra = true;
+   TiempoAnterior = TIEMPO;
+   if (ERROR > Maximo) Maximo = ERROR;
+   if (ERROR < Minimo) Minimo = ERROR;
+
+   if (!ReleAlto && ERROR > Histeresis) {
+      ReleAlto = true;
+      if (Ciclos > 0) {
+         // Ciclo completo: el primero es transitorio y no se promedia.
+         SumaPeriodos += DesdeCambio / 1e6;
+         SumaAmplitudes += (Maximo - Minimo) / 2;
+      }
+      Ciclos++;
+      DesdeCambio = 0;
+      Maximo = ERROR;
+      Minimo = ERROR;
+      if (Ciclos > CiclosPedidos) {
+         Terminar();
+         return PID->Controlar(ERROR, TIEMPO);
+      }
+   } else if (ReleAlto && ERROR < -Histeresis) {
+      ReleAlto = false;
+   }
+   if (DuracionMaxima>0 && DesdeCambio>DuracionMaxima) {
+      Estado = EstadoSintonia::Fallida;      // La planta no oscila (o está saturada)
+      PID->Apagar();                         // Sin el tiempo ni el error de antes de la sintonía
+   }
+   return ReleAlto ? Centro+Amplitud : Centro-Amplitud;
+}
+//-------------------------------------------------------------------------------------
+
+void autoSintoniaPID::Terminar()
+{  float Pu = SumaPeriodos / CiclosPedidos;
+   float a = SumaAmplitudes / CiclosPedidos;
+   float Raiz = sqrt(max(a*a - Histeresis*Histeresis, 1e-12f));
+   float Ku = 4*Amplitud / (3.14159265f*Raiz);   // Sin la macro PI (no existe en la PC)
+   float Kp, Ti, Td=0;
+   switch (Regla) {
+      case ReglaSintonia::ZieglerNichols:   Kp = 0.6f*Ku;  Ti = Pu/2;    Td = Pu/8;   break;
+      case ReglaSintonia::ZieglerNicholsPI: Kp = 0.45f*Ku; Ti = Pu/1.2f;              break;
+      case ReglaSintonia::TyreusLuyben:     Kp = Ku/2.2f;  Ti = 2.2f*Pu; Td = Pu/6.3f; break;
+      default:                              Kp = Ku/3.2f;  Ti = 2.2f*Pu;              break;
+   }
+   GananciaCritica = Ku;
+   PeriodoCritico = Pu;
+   PID->ConfigurarPID(Kp, Ti, Td);
+   Estado = EstadoSintonia::Terminada;
+}
+//-------------------------------------------------------------------------------------
+
+void autoSintoniaPID::Cancelar()
+// El PID vuelve desde una primera muestra: si no, integraría todo el ensayo del relé.
+{  if (Estado!=EstadoSintonia::EnCurso) return;
+   PID->Apagar();
+   Estado = EstadoSintonia::Inactiva;
+}
+//-------------------------------------------------------------------------------------
+
+EstadoSintonia autoSintoniaPID::ObtenerEstado()
+{  return Estado;
+}
+//-------------------------------------------------------------------------------------
+
+float autoSintoniaPID::ObtenerGananciaCritica()
+{  return GananciaCritica;
+}
+//-------------------------------------------------------------------------------------
+
+float autoSintoniaPID::ObtenerPeriodoCritico()
+{  return PeriodoCritico;
+}
+//-------------------------------------------------------------------------------------
@@ -0,0 +1,108 @@
+/****************************************************************************************
+  ControlPIDAutoSintonia.h
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Sintonía automática de un controlPID por el método del relé (Åström-
+           Hägglund). Mientras dura, en lugar del PID actúa un relé con histéresis
+           sobre el error: la salida vale CENTRO+AMPLITUD o CENTRO-AMPLITUD y la planta
+           oscila en su período crítico. Se mide el período Pu y la amplitud a del
+           error en varios ciclos; la ganancia crítica es
+              Ku = 4*AMPLITUD / (pi*sqrt(a^2 - HISTERESIS^2))
+           y con la regla elegida se calculan Kp, Ti y Td y se llama a ConfigurarPID().
+              Regla                 Kp        Ti        Td
+              ZieglerNichols        0.6 Ku    Pu/2      Pu/8
+              ZieglerNicholsPI      0.45 Ku   Pu/1.2    0
+              TyreusLuyben          Ku/2.2    2.2 Pu    Pu/6.3
+              TyreusLuybenPI        Ku/3.2    2.2 Pu    0
+           Tyreus-Luyben es más conservadora (menos sobrepico): conviene en procesos
+           térmicos lentos.
+           Ejecuta una muestra por llamada, sin bloquear ni usar memoria dinámica.
+           El primer ciclo se descarta (transitorio).
+-----------------------------------------------------------------------------------------
+  Uso:
+           autoSintoniaPID Sintonia(&PID);
+           Sintonia.Iniciar(50, 20, 0.5, ReglaSintonia::TyreusLuyben);
+           ...
+           // En cada período, en lugar de PID.Controlar():
+           Salida = Sintonia.Controlar(Error, micros());
+           // Al terminar, Controlar() sigue con el PID ya configurado.
+           Iniciar() apaga el PID (ver controlPID::Apagar()); al terminar, fallar o
+           cancelarse la sintonía el PID arranca de una primera muestra, sin integrar
+           el tiempo ni el error del ensayo.
+-----------------------------------------------------------------------------------------
+  Autor:   Colaboradores de ControlPID, sobre la biblioteca original de
+           Guillermo Caporaletti <gfcaporaletti@undav.edu.ar>
+           Sistemas de Control Automático (SCA)
+           Universidad Nacional de Avellaneda (UNDAV)
+  Fecha:   Octubre 2026
+  Version: 1.1
+****************************************************************************************/
+
+#ifndef CONTROLPIDAUTOSINTONIA_h
+#define CONTROLPIDAUTOSINTONIA_h
+#include "Arduino.h"
+#include "ControlPID.h"
+
+/***************************************************************************************/
+
+enum class ReglaSintonia : uint8_t   // Regla para pasar de (Ku, Pu) a las constantes del PID
+{  ZieglerNichols,
+   ZieglerNicholsPI,
+   TyreusLuyben,
+   TyreusLuybenPI
+};
+
+enum class EstadoSintonia : uint8_t
+{  Inactiva,                         // No se inició (Controlar() usa el PID)
+   EnCurso,                          // Actúa el relé
+   Terminada,                        // Se configuró el PID (Controlar() lo usa)
+   Fallida                           // No hubo oscilación en el tiempo máximo (no cambiaron las
+                                     // constantes del PID)
+};
+
+/***************************************************************************************/
+
+class autoSintoniaPID                // Sintonía por relé de un controlPID
+{  private:
+      controlPID* PID;
+      float Centro;                  // Salida alrededor de la cual oscila el relé
+      float Amplitud;                // Amplitud del relé (negativa si Kp debe ser negativo)
+      float Histeresis;              // Histéresis del relé sobre el error
+      ReglaSintonia Regla;
+      uint8_t CiclosPedidos;         // Ciclos a promediar (sin contar el primero)
+      uint8_t Ciclos;                // Ciclos completos medidos (incluido el descartado)
+      EstadoSintonia Estado;
+      boolean ReleAlto;              // Estado del relé
+      boolean HayMuestra;            // Ya hubo una muestra (TiempoAnterior es válido)
+      unsigned long DuracionMaxima;  // Tiempo máximo sin completar un ciclo (0: sin límite)
+      unsigned long TiempoAnterior;  // Tiempo de la muestra anterior
+      unsigned long DesdeCambio;     // Tiempo desde que el relé pasó a alto (en microsegundos)
+      float Maximo, Minimo;          // Extremos del error en el ciclo en curso
+      float SumaPeriodos;            // Sumas de los ciclos promediados (en segundos y unidades del error)
+      float SumaAmplitudes;
+      float GananciaCritica;         // Ku y Pu medidos
+      float PeriodoCritico;
+      void Terminar();               // Calcula y configura las constantes.
+
+   public:
+      autoSintoniaPID(controlPID* PID);
+      void Iniciar(float CENTRO, float AMPLITUD, float HISTERESIS, ReglaSintonia REGLA, uint8_t CICLOS = 3);
+                                                           // Empieza la sintonía: la salida oscilará entre
+                                                           // CENTRO-AMPLITUD y CENTRO+AMPLITUD (dentro de lo que
+                                                           // admita el actuador). HISTERESIS, en unidades del error,
+                                                           // debe superar el ruido de la medición.
+      void LimitarDuracion(unsigned long MAXIMO);          // Tiempo máximo por ciclo (en microsegundos, menos de
+                                                           // 71 minutos): si se supera, la sintonía falla.
+      float Controlar(float ERROR, unsigned long TIEMPO);  // Una muestra con el tiempo TIEMPO (en microsegundos).
+                                                           // Devuelve la salida del relé o, si no hay sintonía en
+                                                           // curso, la del PID.
+      float Controlar(float ERROR);                        // Ídem, con micros().
+      void Cancelar();                                     // Interrumpe la sintonía sin cambiar las constantes.
+      EstadoSintonia ObtenerEstado();
+      float ObtenerGananciaCritica();                      // Ku (0 si no terminó).
+      float ObtenerPeriodoCritico();                       // Pu en segundos (0 si no terminó).
+};
+
+/***************************************************************************************/
+
+#endif
@@ -0,0 +1,266 @@
+/****************************************************************************************
+  ControlPIDBank.h
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Banco de N controles PID que se calculan juntos en una sola llamada.
+           Los parámetros y estados se guardan como arreglos paralelos (uno por
+           variable) en lugar de N objetos controlPID: el lazo de cálculo recorre
+           memoria contigua y casi no tiene bifurcaciones, de modo que el compilador
+           puede vectorizarlo en procesadores con SIMD.
+           Mismo criterio anti-enrole que controlPID (límite y condicional de integral).
+-----------------------------------------------------------------------------------------
+  Uso:
+           controlPIDBank<16> Zonas;
+           Zonas.ConfigurarPID(i, KP, TI, TD);
+           Zonas.LimitarSalida(i, true, SMIN, SMAX);
+           Zonas.ControlarTodos(Errores, Salidas, micros());
+           Todos los PID del banco comparten la misma medición de tiempo (y la misma
+           política de demora, ver controlPID::LimitarIntervalo()).
+-----------------------------------------------------------------------------------------
+  Autor:   Colaboradores de ControlPID, sobre la biblioteca original de
+           Guillermo Caporaletti <gfcaporaletti@undav.edu.ar>
+           Sistemas de Control Automático (SCA)
+           Universidad Nacional de Avellaneda (UNDAV)
+  Fecha:   Octubre 2026
+  Version: 1.1
+****************************************************************************************/
+
+#ifndef CONTROLPIDBANK_h
+#define CONTROLPIDBANK_h
+#include "Arduino.h"
+#include "ControlPID.h"
+#include <float.h>
+
+/***************************************************************************************/
+
+template <uint8_t N>
+class controlPIDBank                 // Banco de N controles PID
+{  private:
+      float Kp[N];                   // Constante proporcional
+      float Ti[N];                   // Tiempo de integración (en segundos)
+      float Td[N];                   // Tiempo para la componente derivativa (en segundos)
+      float KiMedio[N];              // Kp/(2*Ti) (0 si Ti=0), precalculado
+      float KpTd[N];                 // Kp*Td, precalculado
+      float Integral[N];             // Componente integral
+      float ErrorAnterior[N];        // Señal de error anterior
+      float MuestraAnterior[N];      // 0 si no hay muestra anterior (no integra ni deriva), 1 si hay
+      float Salida[N];               // Última salida calculada
+      float SalidaMin[N];            // Límites de salida efectivos
+      float SalidaMax[N];            // (±FLT_MAX si no se limita la salida)
+      float IntegralMin[N];          // Límites de integral efectivos
+      float IntegralMax[N];          // (±FLT_MAX si no se limita la integral)
+      float LimiteMin[N];            // Límites configurados con LimitarSalida()
+      float LimiteMax[N];
+      boolean LimitaSalida[N];       // Indica si limitamos la salida
+      boolean LimitaIntegral[N];     // Indica si limitamos la integral (con los límites de salida)
+      boolean CondicionaIntegral[N]; // Indica si no integra mientras la salida esté saturada
+      unsigned long TiempoAnterior;  // Tiempo de la medición anterior (en microsegundos)
+      unsigned long IntervaloMaximo; // Intervalo máximo entre muestras (0 si no se controla)
+      unsigned long Demoras;         // Cantidad de intervalos que superaron el máximo
+      DemoraPID PoliticaDemora;      // Qué hacer cuando se supera IntervaloMaximo
+      boolean PrimeraMuestra;        // Indica que el banco no tiene muestra anterior
+      static const float MILLON;     // Constante para convertir micros() a segundos.
+      void ActualizarLimites(uint8_t i);  // Recalcula los límites efectivos del PID i.
+
+   public:
+      controlPIDBank();                                    // Todos los PID en cero y sin límites.
+      void ConfigurarPID(uint8_t i, float KP, float TI, float TD);
+                                                           // Igual que controlPID::ConfigurarPID() para el PID i.
+      boolean LimitarSalida(uint8_t i, boolean RESPUESTA, float SMIN, float SMAX);
+      boolean LimitarSalida(uint8_t i, boolean RESPUESTA);
+      boolean LimitarSalida(uint8_t i)         { return LimitaSalida[i]; }
+      boolean LimitarIntegral(uint8_t i, boolean RESPUESTA);
+      boolean LimitarIntegral(uint8_t i)       { return LimitaIntegral[i]; }
+      boolean CondicionarIntegral(uint8_t i, boolean RESPUESTA);
+      boolean CondicionarIntegral(uint8_t i)   { return CondicionaIntegral[i]; }
+      void ControlarTodos(const float* ERRORES, float* SALIDAS, unsigned long TIEMPO);
+                                                           // Calcula las N salidas con los N errores
+                                                           // y el tiempo actual TIEMPO (en microsegundos).
+      void LimitarIntervalo(unsigned long MAXIMO, DemoraPID POLITICA);
+                                                           // Igual que controlPID::LimitarIntervalo(), para
+                                                           // todo el banco. Con MAXIMO=0 no se controla.
+      unsigned long ObtenerDemoras()           { return Demoras; }
+      void Apagar(uint8_t i);                              // Apaga el PID i y resetea sus valores.
+      void Apagar();                                       // Apaga todo el banco.
+      float ObtenerIntegral(uint8_t i)         { return Integral[i]; }
+      float ObtenerSalida(uint8_t i)           { return Salida[i]; }
+      uint8_t Cantidad()                       { return N; }
+};
+
+/***************************************************************************************/
+// Implementación (en el encabezado por tratarse de una plantilla)
+/***************************************************************************************/
+
+template <uint8_t N>
+const float controlPIDBank<N>::MILLON = 1e6;
+
+template <uint8_t N>
+controlPIDBank<N>::controlPIDBank()
+{  for (uint8_t i=0; i<N; i++) {
+      LimiteMin[i]=0;
+      LimiteMax[i]=0;
+      LimitaSalida[i]=false;
+      LimitaIntegral[i]=false;
+      CondicionaIntegral[i]=false;
+      ConfigurarPID(i, 0, 0, 0);
+   }
+   IntervaloMaximo=0;
+   Demoras=0;
+   PoliticaDemora=DemoraPID::Recortar;
+   Apagar();
+}
+//-------------------------------------------------------------------------------------
+
+template <uint8_t N>
+void controlPIDBank<N>::ConfigurarPID(uint8_t i, float KP, float TI, float TD)
+// Configura las constantes del PID i y precalcula sus coeficientes.
+// Resetea valores de integración del PID i.
+{  Kp[i]=KP;
+   Ti[i]=TI;
+   Td[i]=TD;
+   KiMedio[i] = (TI!=0) ? KP/(2*TI) : 0;
+   KpTd[i] = KP*TD;
+   ActualizarLimites(i);
+   Apagar(i);
+}
+//-------------------------------------------------------------------------------------
+
+template <uint8_t N>
+boolean controlPIDBank<N>::LimitarSalida(uint8_t i, boolean RESPUESTA)
+// No permite activar límites si antes no fueron establecidos.
+{  LimitaSalida[i]=RESPUESTA;
+   if (LimiteMax[i]==0 && LimiteMin[i]==0) LimitaSalida[i]=false;
+   ActualizarLimites(i);
+   return LimitaSalida[i];
+}
+//-------------------------------------------------------------------------------------
+
+template <uint8_t N>
+boolean controlPIDBank<N>::LimitarSalida(uint8_t i, boolean RESPUESTA, float SMIN, float SMAX)
+// No activa con SMIN=SMAX ni con SMIN>SMAX.
+{  LimiteMin[i]=SMIN;
+   LimiteMax[i]=SMAX;
+   LimitaSalida[i]=RESPUESTA;
+   if (SMIN>=SMAX) LimitaSalida[i]=false;
+   ActualizarLimites(i);
+   return LimitaSalida[i];
+}
+//-------------------------------------------------------------------------------------
+
+template <uint8_t N>
+boolean controlPIDBank<N>::LimitarIntegral(uint8_t i, boolean RESPUESTA)
+// Limita la integral del PID i entre los mismos márgenes de la salida.
+{  LimitaIntegral[i]=RESPUESTA;
+   if (LimiteMax[i]==LimiteMin[i]) LimitaIntegral[i]=false;
+   ActualizarLimites(i);
+   return LimitaIntegral[i];
+}
+//-------------------------------------------------------------------------------------
+
+template <uint8_t N>
+boolean controlPIDBank<N>::CondicionarIntegral(uint8_t i, boolean RESPUESTA)
+// No integra mientras la salida esté saturada. Requiere límites de salida activos.
+{  CondicionaIntegral[i] = RESPUESTA && LimitaSalida[i];
+   return CondicionaIntegral[i];
+}
+//-------------------------------------------------------------------------------------
+
+template <uint8_t N>
+void controlPIDBank<N>::LimitarIntervalo(unsigned long MAXIMO, DemoraPID POLITICA)
+{  IntervaloMaximo=MAXIMO;
+   PoliticaDemora=POLITICA;
+}
+//-------------------------------------------------------------------------------------
+
+template <uint8_t N>
+void controlPIDBank<N>::ActualizarLimites(uint8_t i)
+// Un límite desactivado se reemplaza por ±FLT_MAX: así el lazo de cálculo
+// satura siempre, sin preguntar si debe hacerlo.
+{  SalidaMin[i] = LimitaSalida[i] ? LimiteMin[i] : -FLT_MAX;
+   SalidaMax[i] = LimitaSalida[i] ? LimiteMax[i] :  FLT_MAX;
+   // Como en controlPID, sin Ti no hay integral que limitar:
+   boolean Limita = LimitaIntegral[i] && Ti[i]!=0;
+   IntegralMin[i] = Limita ? LimiteMin[i] : -FLT_MAX;
+   IntegralMax[i] = Limita ? LimiteMax[i] :  FLT_MAX;
+   if (!LimitaSalida[i]) CondicionaIntegral[i]=false;
+}
+//-------------------------------------------------------------------------------------
+
+template <uint8_t N>
+void controlPIDBank<N>::ControlarTodos(const float* ERRORES, float* SALIDAS, unsigned long TIEMPO)
+// Calcula las salidas de todo el banco.
+// El intervalo (y su inversa, única división) se calcula una vez para todos.
+{  float Intervalo = 0;               // En segundos
+   float InversaIntervalo = 0;
+   // Como en controlPID::MedirIntervalo(): micros() es de 32 bits y la resta en
+   // 32 bits es correcta aunque haya desbordado entre ambas muestras.
+   uint32_t Microsegundos = PrimeraMuestra ? 0 : (uint32_t)(TIEMPO-TiempoAnterior);
+   TiempoAnterior = TIEMPO;
+   PrimeraMuestra = false;
+   if (IntervaloMaximo>0 && Microsegundos>IntervaloMaximo) {
+      // Demora: igual que controlPID::RevisarDemora().
+      Demoras++;
+      switch (PoliticaDemora) {
+         case DemoraPID::Recortar:      Microsegundos = IntervaloMaximo; break;
+         case DemoraPID::Resincronizar: Microsegundos = 0;               break;
+         case DemoraPID::Apagar:
+            for (uint8_t i=0; i<N; i++) Apagar(i);                    // Conserva TiempoAnterior
+            Microsegundos = 0;
+            break;
+      }
+   }
+   if (Microsegundos>0) {
+      Intervalo = Microsegundos / MILLON;
+      InversaIntervalo = 1 / Intervalo;
+   }
+
+   for (uint8_t i=0; i<N; i++) {
+      float Error = ERRORES[i];
+      float HayAnterior = MuestraAnterior[i];  // 0 ó 1: anula integral y derivativa sin bifurcar
+      float Proporcional = Kp[i]*Error;
+      float Derivativo = HayAnterior * KpTd[i]*(Error-ErrorAnterior[i])*InversaIntervalo;
+
+      // ¿Debo saturar salida? Con límites desactivados nunca satura.
+      float Previa = Proporcional + Integral[i] + Derivativo;
+      boolean Saturada = (Previa > SalidaMax[i]) || (Previa < SalidaMin[i]);
+
+      // Integral (no integra si está condicionada y la salida saturada):
+      float Incremento = HayAnterior * KiMedio[i]*(Error+ErrorAnterior[i])*Intervalo;
+      Incremento = (CondicionaIntegral[i] && Saturada) ? 0 : Incremento;
+      float Acumulada = Integral[i] + Incremento;
+      Acumulada = min(Acumulada, IntegralMax[i]);
+      Acumulada = max(Acumulada, IntegralMin[i]);
+      Integral[i] = Acumulada;
+
+      // Cálculo final completo:
+      float Total = Proporcional + Acumulada + Derivativo;
+      Total = min(Total, SalidaMax[i]);
+      Total = max(Total, SalidaMin[i]);
+      Salida[i] = Total;
+      SALIDAS[i] = Total;
+      ErrorAnterior[i] = Error;
+      MuestraAnterior[i] = 1;
+   }
+}
+//-------------------------------------------------------------------------------------
+
+template <uint8_t N>
+void controlPIDBank<N>::Apagar(uint8_t i)
+// No se modifican las constantes ni los límites.
+{  Integral[i]=0;
+   ErrorAnterior[i]=0;
+   Salida[i]=0;
+   MuestraAnterior[i]=0;
+}
+//-------------------------------------------------------------------------------------
+
+template <uint8_t N>
+void controlPIDBank<N>::Apagar()
+{  for (uint8_t i=0; i<N; i++) Apagar(i);
+   TiempoAnterior=0;
+   PrimeraMuestra=true;
+}
+
+/***************************************************************************************/
+
+#endif
@@ -0,0 +1,133 @@
+/****************************************************************************************
+  ControlPIDCascada.h
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Cascada de hasta N lazos controlPID (por ejemplo posición -> velocidad ->
+           corriente): la salida de cada lazo es la referencia del siguiente y el
+           último maneja el actuador.
+           Ejecutar() se llama al ritmo del lazo más interno con un único tiempo para
+           todos; cada lazo externo corre una vez cada RELACION ejecuciones del
+           siguiente.
+           Si un lazo interno recorta su salida, el externo lo recibe como saturación
+           externa: con CondicionarIntegral su integral deja de crecer aunque su
+           propia salida no llegue a sus límites. La saturación externa también
+           cuenta como saturada (EstaSaturada()), de modo que sigue hacia afuera
+           hasta el lazo más externo (ver extras/host/cascada).
+           Cada lazo deriva su medición (ControlarMedicion()): un cambio de la
+           referencia que llega del lazo externo no produce picos.
+-----------------------------------------------------------------------------------------
+  Uso:
+           cascadaPID<3> Cascada(EscribirPWM);
+           Cascada.Agregar(&PIDPosicion, LeerPosicion, 1);
+           Cascada.Agregar(&PIDVelocidad, LeerVelocidad, 5);    // 5 veces por cada posición
+           Cascada.Agregar(&PIDCorriente, LeerCorriente, 4);    // 4 veces por cada velocidad
+           Cascada.FijarReferencia(100);
+           ...
+           // Cada período del lazo de corriente (en la interrupción del timer):
+           Cascada.Ejecutar(micros());
+-----------------------------------------------------------------------------------------
+  Autor:   Colaboradores de ControlPID, sobre la biblioteca original de
+           Guillermo Caporaletti <gfcaporaletti@undav.edu.ar>
+           Sistemas de Control Automático (SCA)
+           Universidad Nacional de Avellaneda (UNDAV)
+  Fecha:   Octubre 2026
+  Version: 1.1
+****************************************************************************************/
+
+#ifndef CONTROLPIDCASCADA_h
+#define CONTROLPIDCASCADA_h
+#include "Arduino.h"
+#include "ControlPID.h"
+
+/***************************************************************************************/
+
+template <uint8_t N>
+class cascadaPID                     // Cascada de hasta N lazos PID (el 0 es el más externo)
+{  private:
+      controlPID* Lazos[N];
+      float (*Mediciones[N])();      // Devuelven la variable medida de cada lazo
+      uint8_t Relacion[N];           // Ejecuciones del lazo por cada ejecución del externo
+      uint8_t Cuenta[N];             // Ejecuciones desde la última del lazo externo
+      float Referencias[N];          // Referencia de cada lazo (salida del externo)
+      boolean SaturacionInterna[N];  // El lazo siguiente saturó desde la última ejecución
+      void (*Actuador)(float);       // Recibe la salida del lazo más interno
+      uint8_t Cantidad;
+
+   public:
+      cascadaPID(void (*ACTUADOR)(float));
+      boolean Agregar(controlPID* PID, float (*MEDICION)(), uint8_t RELACION);
+                                                           // Agrega un lazo, del más externo al más interno.
+                                                           // RELACION: cuántas veces corre por cada ejecución
+                                                           // del lazo anterior (en el primero no se usa).
+                                                           // Devuelve false si no hay lugar o RELACION es 0.
+      void FijarReferencia(float REFERENCIA);              // Referencia del lazo más externo.
+      uint8_t Ejecutar(unsigned long AHORA);               // Un período del lazo más interno con el tiempo
+                                                           // AHORA (en microsegundos) para todos los lazos.
+                                                           // Devuelve cuántos lazos corrieron.
+      float ObtenerReferencia(uint8_t i);                  // Referencia actual del lazo i.
+      uint8_t ObtenerCantidad() { return Cantidad; }
+};
+
+/***************************************************************************************/
+// Implementación (en el encabezado por tratarse de una plantilla)
+/***************************************************************************************/
+
+template <uint8_t N>
+cascadaPID<N>::cascadaPID(void (*ACTUADOR)(float))
+{  Actuador=ACTUADOR;
+   Cantidad=0;
+}
+//-------------------------------------------------------------------------------------
+
+template <uint8_t N>
+boolean cascadaPID<N>::Agregar(controlPID* PID, float (*MEDICION)(), uint8_t RELACION)
+{  if (Cantidad>=N || PID==NULL || MEDICION==NULL || RELACION==0) return false;
+   Lazos[Cantidad] = PID;
+   Mediciones[Cantidad] = MEDICION;
+   Relacion[Cantidad] = RELACION;
+   Cuenta[Cantidad] = 0;
+   Referencias[Cantidad] = 0;
+   SaturacionInterna[Cantidad] = false;
+   Cantidad++;
+   return true;
+}
+//-------------------------------------------------------------------------------------
+
+template <uint8_t N>
+void cascadaPID<N>::FijarReferencia(float REFERENCIA)
+{  Referencias[0] = REFERENCIA;
+}
+//-------------------------------------------------------------------------------------
+
+template <uint8_t N>
+uint8_t cascadaPID<N>::Ejecutar(unsigned long AHORA)
+{  if (Cantidad==0) return 0;
+   // Los lazos que corren son el interno y los externos cuya cuenta volvió a cero:
+   uint8_t Primero = Cantidad-1;
+   while (Primero>0 && Cuenta[Primero]==0) Primero--;
+   for (uint8_t i=Primero; i<Cantidad; i++) {
+      controlPID* PID = Lazos[i];
+      float Medicion = Mediciones[i]();
+      if (i+1<Cantidad) {
+         PID->IndicarSaturacionExterna(SaturacionInterna[i]);
+         SaturacionInterna[i] = false;
+      }
+      float Salida = PID->ControlarMedicion(Referencias[i]-Medicion, Medicion, AHORA);
+      if (i>0 && PID->EstaSaturada()) SaturacionInterna[i-1] = true;
+      if (i+1<Cantidad) Referencias[i+1] = Salida;
+      else if (Actuador) Actuador(Salida);
+      if (++Cuenta[i] >= Relacion[i]) Cuenta[i] = 0;
+   }
+   return Cantidad-Primero;
+}
+//-------------------------------------------------------------------------------------
+
+template <uint8_t N>
+float cascadaPID<N>::ObtenerReferencia(uint8_t i)
+{  return (i<Cantidad) ? Referencias[i] : 0;
+}
+//-------------------------------------------------------------------------------------
+
+/***************************************************************************************/
+
+#endif
@@ -0,0 +1,148 @@
+/***********************************************************************************
+  ControlPIDDSP.cpp
+-----------------------------------------------------------------------------------
+  Descripción:
+           PID de período fijo sobre arm_pid_f32 (CMSIS-DSP) o su versión portable.
+-----------------------------------------------------------------------------------
+  Autor:   Colaboradores de ControlPID, sobre la biblioteca original de
+           Guillermo Caporaletti <gfcaporaletti@undav.edu.ar>
+           Sistemas de Control Automático (SCA)
+           Universidad Nacional de Avellaneda (UNDAV)
+  Fecha:   Octubre 2026
+  Version: 1.1
+***********************************************************************************/
+
+#include "Arduino.h"
+#include "ControlPIDDSP.h"
+
+/**************************************************************************************/
+
+#ifndef CONTROLPID_CMSIS
+static inline float arm_pid_f32(instanciaPIDDSP* S, float ENTRADA)
+// Mismo cálculo (y mismo orden de operaciones) que la función de CMSIS-DSP.
+{  float Salida = (S->A0 * ENTRADA) + (S->A1 * S->state[0]) + (S->A2 * S->state[1]) + S->state[2];
+   S->state[1] = S->state[0];
+   S->state[0] = ENTRADA;
+   S->state[2] = Salida;
+   return Salida;
+}
+#endif
+
+/**************************************************************************************/
+
+controlPIDDSP::controlPIDDSP(float KP, float TI, float TD, unsigned long PERIODO)
+{  LimitaSalida=false;
+   LimitaIntegral=false;
+   CondicionaIntegral=false;
+   SalidaMax=0;
+   SalidaMin=0;
+   ConfigurarPID(KP, TI, TD, PERIODO);
+}
+//-------------------------------------------------------------------------------------
+
+void controlPIDDSP::ConfigurarPID(float KP, float TI, float TD)
+{  ConfigurarPID(KP, TI, TD, Periodo);
+}
+//-------------------------------------------------------------------------------------
+
+void controlPIDDSP::ConfigurarPID(float KP, float TI, float TD, unsigned long PERIODO)
+// Ganancias por muestra como arm_pid_init_f32: Ki = Kp*Ts/Ti, Kd = Kp*Td/Ts.
+{  float Ts = PERIODO / 1e6;
+   Ki = (TI!=0 && PERIODO>0) ? KP*Ts/TI : 0;
+   float Kd = (PERIODO>0) ? KP*TD/Ts : 0;
+   Periodo = PERIODO;
+   Instancia.A0 = KP + Ki + Kd;
+   Instancia.A1 = -KP - 2*Kd;
+   Instancia.A2 = Kd;
+   Apagar();
+}
+//-------------------------------------------------------------------------------------
+
+boolean controlPIDDSP::ConfigurarCoeficientes(const coeficientesPID& COEFICIENTES)
+{  if (COEFICIENTES.A1!=1 || COEFICIENTES.A2!=0) return false;
+   Instancia.A0 = COEFICIENTES.B0;
+   Instancia.A1 = COEFICIENTES.B1;
+   Instancia.A2 = COEFICIENTES.B2;
+   Ki = COEFICIENTES.B0 + COEFICIENTES.B1 + COEFICIENTES.B2;
+   Apagar();
+   return true;
+}
+//-------------------------------------------------------------------------------------
+
+boolean controlPIDDSP::LimitarSalida(boolean RESPUESTA, float SMIN, float SMAX)
+{  if (SMIN>=SMAX) return false;
+   SalidaMin=SMIN;
+   SalidaMax=SMAX;
+   LimitaSalida=RESPUESTA;
+   if (!LimitaSalida) {
+      LimitaIntegral=false;
+      CondicionaIntegral=false;
+   }
+   return true;
+}
+//-------------------------------------------------------------------------------------
+
+boolean controlPIDDSP::LimitarIntegral(boolean RESPUESTA)
+{  LimitaIntegral = RESPUESTA && LimitaSalida;
+   return LimitaIntegral;
+}
+//-------------------------------------------------------------------------------------
+
+boolean controlPIDDSP::CondicionarIntegral(boolean RESPUESTA)
+{  CondicionaIntegral = RESPUESTA && LimitaSalida;
+   return CondicionaIntegral;
+}
+//-------------------------------------------------------------------------------------
+
+float controlPIDDSP::Controlar(float ERROR)
+// La primera muestra es sólo proporcional, como en controlPID: el estado se siembra con
+// e[-1]=e[-2]=e[0] (sin salto derivativo Kd*e[0]) y u[-1]=Kp*e[0] (sin integrar),
+// con Kp = -(A1 + 2*A2). Desde la segunda muestra sigue arm_pid_f32.
+{  boolean Integro = !PrimeraMuestra;
+   if (PrimeraMuestra) {
+      PrimeraMuestra = false;
+      Salida = -(Instancia.A1 + 2*Instancia.A2) * ERROR;
+      Instancia.state[0] = ERROR;
+      Instancia.state[1] = ERROR;
+      Instancia.state[2] = Salida;
+   }
+   else Salida = arm_pid_f32(&Instancia, ERROR);
+   if (LimitaSalida) {
+      float SalidaSinLimitar = Salida;
+      Salida = min(Salida, SalidaMax);
+      Salida = max(Salida, SalidaMin);
+      if (CondicionaIntegral && Integro && Salida!=SalidaSinLimitar) {
+         Instancia.state[2] -= Ki*ERROR;            // Esta muestra no integra
+      }
+      if (LimitaIntegral) {
+         // u[n] = P + I + D, con P = Kp*e[n] y D = Kd*(e[n]-e[n-1]): se recorta sólo I.
+         float Kd = Instancia.A2;
+         float Directa = -(Instancia.A1 + 2*Kd)*Instancia.state[0] + Kd*(Instancia.state[0]-Instancia.state[1]);
+         float Integral = Instancia.state[2] - Directa;
+         Integral = min(Integral, SalidaMax);
+         Integral = max(Integral, SalidaMin);
+         Instancia.state[2] = Directa + Integral;
+      }
+   }
+   return Salida;
+}
+//-------------------------------------------------------------------------------------
+
+void controlPIDDSP::Apagar()
+{  Instancia.state[0]=0;
+   Instancia.state[1]=0;
+   Instancia.state[2]=0;
+   Salida=0;
+   PrimeraMuestra=true;
+}
+//-------------------------------------------------------------------------------------
+
+boolean controlPIDDSP::Acelerado()
+{
+#ifdef CONTROLPID_CMSIS
+   return true;
+#else
+   return false;
+#endif
+}
+//-------------------------------------------------------------------------------------
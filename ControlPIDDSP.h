@@ -0,0 +1,112 @@
+/****************************************************************************************
+  ControlPIDDSP.h
+-----------------------------------------------------------------------------------------
+  Descripción:
+           PID de período fijo que delega la actualización en arm_pid_f32 de CMSIS-DSP
+           cuando está disponible (Cortex-M4F/M7 con arm_math.h: núcleo con
+           instrucciones DSP) y, si no, en una versión portable del mismo cálculo:
+              u[n] = u[n-1] + A0*e[n] + A1*e[n-1] + A2*e[n-2]
+           (forma de velocidad con integral de Euler hacia atrás y derivativa sin
+           filtro, como arm_pid_init_f32). Como en controlPID, la primera muestra
+           (tras construir, configurar o Apagar) es sólo proporcional: el estado se
+           siembra con el primer error, sin salto derivativo ni integración. Desde la
+           segunda coincide con controlPID configurado con
+           ConfigurarDiscretizacion(EulerAtras, EulerAtras) y sin filtro derivativo
+           (controlPID integra por Tustin por omisión). ESP-DSP no tiene PID: en ESP32 se usa la
+           versión portable. Para punto fijo (arm_pid_q15/q31) ver ControlPID_Q.h.
+           La saturación se agrega alrededor de la función:
+           - LimitarSalida: recorta la salida. Sin anti-enrole el estado interno
+             u[n-1] conserva el valor sin recortar (enrola como controlPID).
+           - LimitarIntegral: la integral se recorta a los límites de salida, como en
+             controlPID. En la forma de velocidad no hay integral aparte: se la
+             obtiene del estado (u[n-1] menos la proporcional y la derivativa de esa
+             muestra), se la recorta y se rearma u[n-1].
+           - CondicionarIntegral: en una muestra con la salida recortada se descuenta
+             del estado el aporte integral de esa muestra (Ki*e[n]): no se integra
+             mientras la salida esté saturada, como en controlPID.
+           Ambos pueden activarse a la vez (primero se descuenta y luego se recorta).
+           Se compila con CMSIS-DSP si el núcleo tiene instrucciones DSP
+           (__ARM_FEATURE_DSP) y existe arm_math.h; CONTROLPID_SIN_CMSIS fuerza la
+           versión portable (por ejemplo, para comparar ambas).
+-----------------------------------------------------------------------------------------
+  Uso:
+           controlPIDDSP PID(KP, TI, TD, PERIODO);
+           PID.LimitarSalida(true, SMIN, SMAX);
+           PID.CondicionarIntegral(true);
+           ...
+           Salida = PID.Controlar(Error);   // cada PERIODO microsegundos
+
+           También puede tomar los coeficientes de un controlPID con período fijo y
+           derivativa sin filtro (ver controlPID::ObtenerCoeficientes()).
+-----------------------------------------------------------------------------------------
+  Autor:   Colaboradores de ControlPID, sobre la biblioteca original de
+           Guillermo Caporaletti <gfcaporaletti@undav.edu.ar>
+           Sistemas de Control Automático (SCA)
+           Universidad Nacional de Avellaneda (UNDAV)
+  Fecha:   Octubre 2026
+  Version: 1.1
+****************************************************************************************/
+
+#ifndef CONTROLPIDDSP_h
+#define CONTROLPIDDSP_h
+#include "Arduino.h"
+#include "ControlPID.h"
+
+#if !defined(CONTROLPID_SIN_CMSIS) && defined(__ARM_FEATURE_DSP) && defined(__has_include)
+#if __has_include(<arm_math.h>)
+#include <arm_math.h>
+#define CONTROLPID_CMSIS             // Controlar() usa arm_pid_f32
+#endif
+#endif
+
+/***************************************************************************************/
+
+#ifdef CONTROLPID_CMSIS
+typedef arm_pid_instance_f32 instanciaPIDDSP;
+#else
+struct instanciaPIDDSP               // Mismos campos que arm_pid_instance_f32
+{  float A0;                         // Kp + Ki + Kd (ganancias por muestra)
+   float A1;                         // -Kp - 2 Kd
+   float A2;                         // Kd
+   float state[3];                   // e[n-1], e[n-2], u[n-1]
+};
+#endif
+
+/***************************************************************************************/
+
+class controlPIDDSP                  // PID sobre arm_pid_f32 (o su equivalente portable)
+{  private:
+      instanciaPIDDSP Instancia;
+      float Ki;                      // Ganancia integral por muestra (A0+A1+A2), para el condicional
+      float Salida;                  // Última salida (recortada)
+      float SalidaMax;               // Límites de salida
+      float SalidaMin;
+      unsigned long Periodo;         // Período de muestreo (en microsegundos)
+      boolean LimitaSalida : 1;
+      boolean LimitaIntegral : 1;    // La integral (parte del estado) se recorta a los límites de salida
+      boolean CondicionaIntegral : 1;  // En saturación se descuenta la integración de la muestra
+      boolean PrimeraMuestra : 1;    // La próxima muestra siembra el estado
+
+   public:
+      controlPIDDSP(float KP, float TI, float TD, unsigned long PERIODO);
+      void ConfigurarPID(float KP, float TI, float TD);    // Cambia constantes, mismo período. Resetea el estado.
+      void ConfigurarPID(float KP, float TI, float TD, unsigned long PERIODO);
+      boolean ConfigurarCoeficientes(const coeficientesPID& COEFICIENTES);
+                                                           // Toma B0..B2 de controlPID::ObtenerCoeficientes().
+                                                           // Devuelve false si no tienen la forma de arm_pid
+                                                           // (A1=1, A2=0: derivativa con filtro o sin EulerAtras).
+      boolean LimitarSalida(boolean RESPUESTA, float SMIN, float SMAX);
+                                                           // Devuelve false (y no los cambia) si SMIN>=SMAX.
+      boolean LimitarIntegral(boolean RESPUESTA);          // Recorta la integral a los límites (requiere LimitarSalida).
+      boolean CondicionarIntegral(boolean RESPUESTA);      // No integra con la salida saturada (requiere LimitarSalida).
+      float Controlar(float ERROR);                        // Calcula la salida (llamar cada PERIODO).
+      void Apagar();                                       // Resetea el estado (no las constantes ni los límites);
+                                                           // la próxima muestra es sólo proporcional.
+      float ObtenerSalida()          { return Salida; }
+      unsigned long ObtenerPeriodo() { return Periodo; }
+      static boolean Acelerado();                          // true si se compiló con CMSIS-DSP.
+};
+
+/***************************************************************************************/
+
+#endif
@@ -0,0 +1,63 @@
+/***********************************************************************************
+  ControlPIDEstado.cpp
+-----------------------------------------------------------------------------------
+  Descripción:
+           Limitación de escrituras del estado de controlPID en memoria no volátil.
+-----------------------------------------------------------------------------------
+  Autor:   Colaboradores de ControlPID, sobre la biblioteca original de
+           Guillermo Caporaletti <gfcaporaletti@undav.edu.ar>
+           Sistemas de Control Automático (SCA)
+           Universidad Nacional de Avellaneda (UNDAV)
+  Fecha:   Octubre 2026
+  Version: 1.1
+***********************************************************************************/
+
+#include "Arduino.h"
+#include "ControlPIDEstado.h"
+#include <stddef.h>
+
+/**************************************************************************************/
+
+guardadoPID::guardadoPID(unsigned long INTERVALO_MINIMO, float UMBRAL)
+{  IntervaloMinimo=INTERVALO_MINIMO;
+   Umbral=UMBRAL;
+   UltimaEscritura=0;
+   Escrituras=0;
+   HayGuardado=false;
+}
+//-------------------------------------------------------------------------------------
+
+void guardadoPID::Inicializar(const estadoPID& ESTADO)
+{  Guardado=ESTADO;
+   HayGuardado=true;
+}
+//-------------------------------------------------------------------------------------
+
+boolean guardadoPID::ConfiguracionDistinta(const estadoPID& ESTADO)
+// Compara todo salvo el punto de operación (Integral..Prealimentacion) y el CRC.
+{  const size_t INICIO = offsetof(estadoPID, Integral);
+   const size_t FIN = offsetof(estadoPID, Periodo);
+   const size_t CRC = offsetof(estadoPID, Crc);
+   return memcmp(&ESTADO, &Guardado, INICIO) != 0
+       || memcmp((const uint8_t*)&ESTADO + FIN, (const uint8_t*)&Guardado + FIN, CRC - FIN) != 0;
+}
+//-------------------------------------------------------------------------------------
+
+boolean guardadoPID::Revisar(const estadoPID& ESTADO, unsigned long AHORA)
+{  if (HayGuardado) {
+      // Resta sin signo: correcta aunque millis() haya desbordado.
+      if (AHORA - UltimaEscritura < IntervaloMinimo) return false;
+      if (!ConfiguracionDistinta(ESTADO) && fabs(ESTADO.Integral - Guardado.Integral) <= Umbral) return false;
+   }
+   Guardado=ESTADO;
+   HayGuardado=true;
+   UltimaEscritura=AHORA;
+   Escrituras++;
+   return true;
+}
+//-------------------------------------------------------------------------------------
+
+unsigned long guardadoPID::ObtenerEscrituras()
+{  return Escrituras;
+}
+//-------------------------------------------------------------------------------------
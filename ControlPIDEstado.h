@@ -0,0 +1,56 @@
+/****************************************************************************************
+  ControlPIDEstado.h
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Decide cuándo conviene escribir el estado de un controlPID (estadoPID) en
+           una memoria de escrituras limitadas (EEPROM: ~100.000 ciclos por celda;
+           flash/NVS del ESP32). Escribe sólo si pasó un intervalo mínimo desde la
+           última escritura y el estado cambió: la configuración en cualquier campo,
+           el punto de operación (integral) en más de un umbral.
+-----------------------------------------------------------------------------------------
+  Uso:
+           guardadoPID Guardado(60000, 0.5);   // A lo sumo cada minuto, si la integral
+                                               // se movió más de 0.5
+           ...
+           PID.GuardarEstado(Estado);
+           if (Guardado.Revisar(Estado, millis())) EEPROM.put(0, Estado);
+-----------------------------------------------------------------------------------------
+  Autor:   Colaboradores de ControlPID, sobre la biblioteca original de
+           Guillermo Caporaletti <gfcaporaletti@undav.edu.ar>
+           Sistemas de Control Automático (SCA)
+           Universidad Nacional de Avellaneda (UNDAV)
+  Fecha:   Octubre 2026
+  Version: 1.1
+****************************************************************************************/
+
+#ifndef CONTROLPIDESTADO_h
+#define CONTROLPIDESTADO_h
+#include "Arduino.h"
+#include "ControlPID.h"
+
+/***************************************************************************************/
+
+class guardadoPID                    // Limita las escrituras del estado en memoria no volátil
+{  private:
+      unsigned long IntervaloMinimo; // Tiempo mínimo entre escrituras (en milisegundos)
+      float Umbral;                  // Cambio de la integral que justifica una escritura
+      unsigned long UltimaEscritura; // millis() de la última escritura
+      unsigned long Escrituras;      // Escrituras autorizadas
+      estadoPID Guardado;            // Último estado escrito
+      boolean HayGuardado;           // Guardado es válido
+      boolean ConfiguracionDistinta(const estadoPID& ESTADO);
+
+   public:
+      guardadoPID(unsigned long INTERVALO_MINIMO, float UMBRAL);
+                                                           // INTERVALO_MINIMO en milisegundos.
+      void Inicializar(const estadoPID& ESTADO);           // Estado que ya está en la memoria (leído al arrancar):
+                                                           // evita reescribirlo si no cambió.
+      boolean Revisar(const estadoPID& ESTADO, unsigned long AHORA);
+                                                           // Indica si hay que escribir ESTADO ahora (AHORA en
+                                                           // milisegundos). Si devuelve true lo da por escrito.
+      unsigned long ObtenerEscrituras();                   // Cantidad de escrituras autorizadas.
+};
+
+/***************************************************************************************/
+
+#endif
@@ -0,0 +1,153 @@
+/****************************************************************************************
+  ControlPIDPerfil.h
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Medición de ciclos de reloj de controlPID::Controlar() en el microcontrolador
+           (con CONTROLPID_PERFIL) y estadística de los intervalos entre muestras
+           (con CONTROLPID_INTERVALOS). Las macros se definen al compilar en todo el
+           proyecto, porque cambian el tamaño de controlPID.
+           Contador de ciclos según la plataforma:
+              Cortex-M3/M4/M7   DWT->CYCCNT
+              ESP32 (Xtensa)    registro CCOUNT
+              RISC-V (ESP32-C3) registro mcycle
+              AVR               Timer1 (TCNT1) sin preescalador
+              PC (x86)          rdtsc
+              Otras             micros() (la unidad pasa a ser microsegundos)
+           En AVR, IniciarContadorCiclos() se apropia de Timer1: se pierde PWM en los
+           pines que usan ese timer (9 y 10 en el Uno) y la biblioteca Servo. Como
+           TCNT1 es de 16 bits, no mide llamadas de más de 65535 ciclos (4 ms a 16 MHz).
+           La llama controlPID::ReiniciarPerfil(), que debe ejecutarse en setup() (o
+           después): init() de Arduino programa Timer1 con preescalador 64 para PWM
+           antes de setup() y después de los constructores de los objetos globales,
+           de modo que iniciarlo en el constructor daría "ciclos" de 64 ciclos.
+-----------------------------------------------------------------------------------------
+  Autor:   Colaboradores de ControlPID, sobre la biblioteca original de
+           Guillermo Caporaletti <gfcaporaletti@undav.edu.ar>
+           Sistemas de Control Automático (SCA)
+           Universidad Nacional de Avellaneda (UNDAV)
+  Fecha:   Octubre 2026
+  Version: 1.1
+****************************************************************************************/
+
+#ifndef CONTROLPIDPERFIL_h
+#define CONTROLPIDPERFIL_h
+#include "Arduino.h"
+
+/***************************************************************************************/
+
+struct perfilPID                     // Estadísticas de las llamadas a Controlar()
+{  uint32_t Llamadas;                // Cantidad de llamadas medidas
+   uint32_t CiclosUltimo;            // Ciclos de la última llamada
+   uint32_t CiclosMin;               // Mínimo de ciclos por llamada
+   uint32_t CiclosMax;               // Máximo de ciclos por llamada
+   uint64_t CiclosTotal;             // Suma de ciclos (para el promedio)
+   uint32_t Saturaciones;            // Llamadas en que se recortó la salida
+   uint32_t IntegralBloqueada;       // Llamadas en que CondicionaIntegral bloqueó la integral
+
+   float CiclosPromedio() const { return Llamadas ? (float)CiclosTotal / Llamadas : 0; }
+   void Reiniciar()
+   {  Llamadas=0; CiclosUltimo=0; CiclosMin=0xFFFFFFFF; CiclosMax=0; CiclosTotal=0;
+      Saturaciones=0; IntegralBloqueada=0;
+   }
+   void Registrar(uint32_t CICLOS, boolean SATURADA, boolean BLOQUEADA)
+   {  Llamadas++;
+      CiclosUltimo = CICLOS;
+      if (CICLOS < CiclosMin) CiclosMin = CICLOS;
+      if (CICLOS > CiclosMax) CiclosMax = CICLOS;
+      CiclosTotal += CICLOS;
+      if (SATURADA) Saturaciones++;
+      if (BLOQUEADA) IntegralBloqueada++;
+   }
+};
+
+/***************************************************************************************/
+
+struct intervalosPID                 // Estadística de los intervalos entre muestras (en microsegundos)
+{  uint32_t Cantidad;                // Cantidad de intervalos registrados
+   uint32_t Minimo;                  // Intervalo mínimo
+   uint32_t Maximo;                  // Intervalo máximo
+   uint32_t Excesos;                 // Intervalos mayores que Objetivo+Tolerancia (si Objetivo>0)
+   uint32_t Objetivo;                // Período esperado (0 si no se configuró)
+   uint32_t Tolerancia;              // Exceso tolerado sobre Objetivo
+   uint32_t Referencia;              // Valor que se resta a cada intervalo antes de sumar:
+   int64_t SumaDesvios;              // Suma de (intervalo - Referencia)
+   uint64_t SumaCuadrados;           // Suma de (intervalo - Referencia)^2
+   // Las sumas son enteras y exactas: no hay divisiones por muestra (a diferencia
+   // de Welford) y la media y la varianza se calculan sólo al consultarlas.
+
+   float Media() const
+   {  return Cantidad ? Referencia + (float)SumaDesvios / Cantidad : 0;
+   }
+   float Varianza() const            // Varianza muestral
+   {  if (Cantidad < 2) return 0;
+      float SumaMedia = (float)SumaDesvios;
+      return ((float)SumaCuadrados - SumaMedia * SumaMedia / Cantidad) / (Cantidad - 1);
+   }
+   float Desvio() const { return sqrt(Varianza()); }
+   void Reiniciar()
+   {  Cantidad=0; Minimo=0xFFFFFFFF; Maximo=0; Excesos=0;
+      Referencia=Objetivo; SumaDesvios=0; SumaCuadrados=0;
+   }
+   void Registrar(uint32_t INTERVALO)
+   {  if (Cantidad==0 && Objetivo==0) Referencia = INTERVALO;  // Sin objetivo: el primer intervalo
+      int32_t Desvio = (int32_t)(INTERVALO - Referencia);
+      Cantidad++;
+      if (INTERVALO < Minimo) Minimo = INTERVALO;
+      if (INTERVALO > Maximo) Maximo = INTERVALO;
+      if (Objetivo>0 && INTERVALO > Objetivo + Tolerancia) Excesos++;
+      SumaDesvios += Desvio;
+      SumaCuadrados += (uint64_t)((int64_t)Desvio * Desvio);
+   }
+};
+
+/***************************************************************************************/
+
+inline void IniciarContadorCiclos()
+// Habilita el contador de ciclos. La llama controlPID::ReiniciarPerfil().
+{
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+   volatile uint32_t* DEMCR = (volatile uint32_t*)0xE000EDFC;
+   volatile uint32_t* DWT_CTRL = (volatile uint32_t*)0xE0001000;
+   *DEMCR |= (1UL << 24);             // TRCENA: habilita DWT
+   *DWT_CTRL |= 1UL;                  // CYCCNTENA: habilita CYCCNT
+#elif defined(__AVR__)
+   TCCR1A = 0;                        // Timer1 en modo normal...
+   TCCR1B = (1 << CS10);              // ...contando a F_CPU
+#endif
+}
+
+inline uint32_t CiclosPerfil()
+// Lectura del contador de ciclos (la diferencia entre dos lecturas da el costo).
+{
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+   return *(volatile uint32_t*)0xE0001004;  // DWT->CYCCNT
+#elif defined(__XTENSA__)
+   uint32_t Ciclos;
+   __asm__ __volatile__("rsr %0, ccount" : "=a"(Ciclos));
+   return Ciclos;
+#elif defined(__riscv)
+   uint32_t Ciclos;
+   __asm__ __volatile__("csrr %0, mcycle" : "=r"(Ciclos));
+   return Ciclos;
+#elif defined(__AVR__)
+   return TCNT1;
+#elif defined(__x86_64__) || defined(__i386__)
+   return (uint32_t)__builtin_ia32_rdtsc();
+#else
+   return micros();
+#endif
+}
+
+inline uint32_t CiclosTranscurridos(uint32_t INICIO)
+// Ciclos desde INICIO, correcto aunque el contador haya desbordado.
+{
+#if defined(__AVR__)
+   return (uint16_t)(CiclosPerfil() - INICIO);  // TCNT1 es de 16 bits
+#else
+   return CiclosPerfil() - INICIO;
+#endif
+}
+
+/***************************************************************************************/
+
+#endif
@@ -0,0 +1,186 @@
+/****************************************************************************************
+  ControlPIDPlanificador.h
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Planificador de hasta N lazos controlPID que comparten una misma base de
+           tiempo periódica (interrupción de timer o tarea de FreeRTOS).
+           Cada lazo tiene su período y dos funciones: una que devuelve el error y otra
+           que recibe la salida. En cada tick se ejecutan los lazos vencidos, primero los
+           de menor período (prioridad monótona por frecuencia). Si un lazo vence con
+           un período completo de atraso se cuenta un exceso y se realinea.
+-----------------------------------------------------------------------------------------
+  Uso:
+           planificadorPID<4> Planificador;
+           Planificador.Registrar(&PIDCorriente, 500, LeerErrorCorriente, EscribirPWM);
+           Planificador.Registrar(&PIDVelocidad, 5000, LeerErrorVelocidad, FijarCorriente);
+           ...
+           // En la interrupción del timer (cada TICK microsegundos, TICK <= menor período):
+           Planificador.Ejecutar(micros());
+           // En ESP32 el planificador puede crear su propio timer:
+           Planificador.Iniciar(TICK);
+
+           Las funciones de entrada y salida se ejecutan dentro de la interrupción:
+           deben ser breves y no usar Serial ni delay().
+-----------------------------------------------------------------------------------------
+  Autor:   Colaboradores de ControlPID, sobre la biblioteca original de
+           Guillermo Caporaletti <gfcaporaletti@undav.edu.ar>
+           Sistemas de Control Automático (SCA)
+           Universidad Nacional de Avellaneda (UNDAV)
+  Fecha:   Octubre 2026
+  Version: 1.1
+****************************************************************************************/
+
+#ifndef CONTROLPIDPLANIFICADOR_h
+#define CONTROLPIDPLANIFICADOR_h
+#include "Arduino.h"
+#include "ControlPID.h"
+#if defined(ESP32)
+#include "esp_timer.h"
+#endif
+
+/***************************************************************************************/
+
+struct lazoPID                       // Un lazo registrado en el planificador
+{  controlPID* PID;                  // Controlador del lazo
+   unsigned long Periodo;            // Período de muestreo (en microsegundos)
+   float (*Entrada)();               // Devuelve el error actual
+   void (*Salida)(float);            // Recibe la salida del PID (actuador)
+   unsigned long Proximo;            // Tiempo de la próxima ejecución
+   unsigned long Excesos;            // Veces que se atrasó un período completo o más
+};
+
+template <uint8_t N>
+class planificadorPID                // Planificador de hasta N lazos PID
+{  private:
+      lazoPID Lazos[N];              // Ordenados por período (menor primero)
+      volatile uint8_t Cantidad;     // Lazos registrados
+      volatile boolean Ocupado;      // Hay un Ejecutar() en curso
+      volatile unsigned long TicksPerdidos;  // Ticks que llegaron con Ejecutar() en curso
+      boolean Sincronizado;          // Ya se fijó el tiempo de la primera ejecución
+#if defined(ESP32)
+      esp_timer_handle_t Timer;
+      static void Tick(void* PLANIFICADOR)
+      {  ((planificadorPID*)PLANIFICADOR)->Ejecutar(micros());
+      }
+#endif
+
+   public:
+      planificadorPID();
+      boolean Registrar(controlPID* PID, unsigned long PERIODO, float (*ENTRADA)(), void (*SALIDA)(float));
+                                                           // Agrega un lazo. Devuelve false si no hay lugar
+                                                           // o si PERIODO es 0. Los lazos arrancan en el
+                                                           // próximo Ejecutar().
+      uint8_t Ejecutar(unsigned long AHORA);               // Ejecuta los lazos vencidos a tiempo AHORA
+                                                           // (en microsegundos). Devuelve cuántos ejecutó.
+      unsigned long ObtenerExcesos(uint8_t i);             // Excesos del lazo i (en orden de período).
+      unsigned long ObtenerTicksPerdidos() { return TicksPerdidos; }
+      uint8_t ObtenerCantidad()            { return Cantidad; }
+#if defined(ESP32)
+      boolean Iniciar(unsigned long TICK);                 // Llama a Ejecutar() cada TICK microsegundos
+                                                           // desde un esp_timer (tarea de alta prioridad).
+      void Detener();
+#endif
+};
+
+/***************************************************************************************/
+// Implementación (en el encabezado por tratarse de una plantilla)
+/***************************************************************************************/
+
+template <uint8_t N>
+planificadorPID<N>::planificadorPID()
+{  Cantidad=0;
+   Ocupado=false;
+   TicksPerdidos=0;
+   Sincronizado=false;
+#if defined(ESP32)
+   Timer=NULL;
+#endif
+}
+//-------------------------------------------------------------------------------------
+
+template <uint8_t N>
+boolean planificadorPID<N>::Registrar(controlPID* PID, unsigned long PERIODO, float (*ENTRADA)(), void (*SALIDA)(float))
+// Inserta el lazo manteniendo el orden por período (prioridad monótona por frecuencia).
+// Se debe registrar antes de empezar a llamar a Ejecutar().
+{  if (Cantidad>=N || PERIODO==0 || PID==NULL || ENTRADA==NULL) return false;
+   uint8_t i = Cantidad;
+   while (i>0 && Lazos[i-1].Periodo > PERIODO) {
+      Lazos[i] = Lazos[i-1];
+      i--;
+   }
+   Lazos[i].PID = PID;
+   Lazos[i].Periodo = PERIODO;
+   Lazos[i].Entrada = ENTRADA;
+   Lazos[i].Salida = SALIDA;
+   Lazos[i].Proximo = 0;
+   Lazos[i].Excesos = 0;
+   Cantidad++;
+   Sincronizado=false;
+   return true;
+}
+//-------------------------------------------------------------------------------------
+
+template <uint8_t N>
+uint8_t planificadorPID<N>::Ejecutar(unsigned long AHORA)
+// Pensado para llamarse desde una interrupción periódica.
+{  if (Ocupado) {
+      // El tick anterior todavía no terminó (los lazos no entran en un tick).
+      TicksPerdidos++;
+      return 0;
+   }
+   Ocupado=true;
+   if (!Sincronizado) {
+      for (uint8_t i=0; i<Cantidad; i++) Lazos[i].Proximo = AHORA;
+      Sincronizado=true;
+   }
+   uint8_t Ejecutados=0;
+   for (uint8_t i=0; i<Cantidad; i++) {
+      lazoPID& Lazo = Lazos[i];
+      // Diferencia con signo: correcta aunque micros() desborde.
+      int32_t Atraso = (int32_t)(uint32_t)(AHORA - Lazo.Proximo);
+      if (Atraso < 0) continue;                  // Todavía no venció
+      float Salida = Lazo.PID->Controlar(Lazo.Entrada(), AHORA);
+      if (Lazo.Salida) Lazo.Salida(Salida);
+      if ((unsigned long)Atraso >= Lazo.Periodo) {
+         // Se perdió al menos una ejecución: realineo en lugar de ponerme al día.
+         Lazo.Excesos++;
+         Lazo.Proximo = AHORA + Lazo.Periodo;
+      } else {
+         Lazo.Proximo += Lazo.Periodo;           // Sin acumular error por deriva del tick
+      }
+      Ejecutados++;
+   }
+   Ocupado=false;
+   return Ejecutados;
+}
+//-------------------------------------------------------------------------------------
+
+template <uint8_t N>
+unsigned long planificadorPID<N>::ObtenerExcesos(uint8_t i)
+{  return (i<Cantidad) ? Lazos[i].Excesos : 0;
+}
+//-------------------------------------------------------------------------------------
+
+#if defined(ESP32)
+template <uint8_t N>
+boolean planificadorPID<N>::Iniciar(unsigned long TICK)
+{  if (Timer==NULL) {
+      esp_timer_create_args_t Argumentos = {};
+      Argumentos.callback = &planificadorPID::Tick;
+      Argumentos.arg = this;
+      Argumentos.name = "planificadorPID";
+      if (esp_timer_create(&Argumentos, &Timer) != ESP_OK) return false;
+   }
+   return esp_timer_start_periodic(Timer, TICK) == ESP_OK;
+}
+//-------------------------------------------------------------------------------------
+
+template <uint8_t N>
+void planificadorPID<N>::Detener()
+{  if (Timer!=NULL) esp_timer_stop(Timer);
+}
+#endif
+
+/***************************************************************************************/
+
+#endif
@@ -0,0 +1,208 @@
+/***********************************************************************************
+  ControlPIDProtocolo.cpp
+-----------------------------------------------------------------------------------
+  Descripción:
+           Protocolo binario (COBS + CRC) para ajuste y telemetría de controlPID.
+-----------------------------------------------------------------------------------
+  Autor:   Colaboradores de ControlPID, sobre la biblioteca original de
+           Guillermo Caporaletti <gfcaporaletti@undav.edu.ar>
+           Sistemas de Control Automático (SCA)
+           Universidad Nacional de Avellaneda (UNDAV)
+  Fecha:   Octubre 2026
+  Version: 1.1
+***********************************************************************************/
+
+#include "Arduino.h"
+#include "ControlPIDProtocolo.h"
+
+/**************************************************************************************/
+
+size_t CodificarCOBS(const uint8_t* ENTRADA, size_t LARGO, uint8_t* SALIDA)
+// Cada grupo empieza con la distancia al próximo 0 (o 0xFF si son 254 bytes sin 0).
+{  size_t Escritos = 1;
+   size_t Codigo = 0;                // Posición del código del grupo en curso
+   uint8_t Distancia = 1;
+   for (size_t i=0; i<LARGO; i++) {
+      if (ENTRADA[i] == 0) {
+         SALIDA[Codigo] = Distancia;
+         Codigo = Escritos++;
+         Distancia = 1;
+      } else {
+         SALIDA[Escritos++] = ENTRADA[i];
+         if (++Distancia == 0xFF) {
+            SALIDA[Codigo] = Distancia;
+            Codigo = Escritos++;
+            Distancia = 1;
+         }
+      }
+   }
+   SALIDA[Codigo] = Distancia;
+   return Escritos;
+}
+//-------------------------------------------------------------------------------------
+
+size_t DecodificarCOBS(const uint8_t* ENTRADA, size_t LARGO, uint8_t* SALIDA)
+{  size_t Escritos = 0;
+   size_t i = 0;
+   while (i < LARGO) {
+      uint8_t Distancia = ENTRADA[i++];
+      if (Distancia == 0 || i + Distancia - 1 > LARGO) return 0;  // No hay ceros en una trama COBS
+      for (uint8_t j=1; j<Distancia; j++) {
+         if (ENTRADA[i] == 0) return 0;
+         SALIDA[Escritos++] = ENTRADA[i++];
+      }
+      // El 0 implícito, salvo al final o después de un grupo completo:
+      if (Distancia != 0xFF && i < LARGO) SALIDA[Escritos++] = 0;
+   }
+   return Escritos;
+}
+//-------------------------------------------------------------------------------------
+
+size_t ArmarTramaPID(TramaPID TIPO, uint8_t LAZO, const void* DATOS, size_t LARGO, uint8_t* TRAMA)
+// Armo la trama sin codificar al final de TRAMA y la codifico hacia el principio:
+// COBS nunca escribe por delante de lo que lee, así que no hace falta otro búfer.
+{  size_t Total = LARGO + 4;
+   uint8_t* Plana = TRAMA + LARGO_TRAMA_PID(LARGO) - Total;
+   Plana[0] = (uint8_t)TIPO;
+   Plana[1] = LAZO;
+   memcpy(Plana + 2, DATOS, LARGO);
+   uint16_t Crc = CrcPID(Plana, LARGO + 2);
+   Plana[LARGO + 2] = Crc & 0xFF;
+   Plana[LARGO + 3] = Crc >> 8;
+   size_t Escritos = CodificarCOBS(Plana, Total, TRAMA);
+   TRAMA[Escritos++] = 0;
+   return Escritos;
+}
+//-------------------------------------------------------------------------------------
+
+size_t AbrirTramaPID(const uint8_t* CODIFICADA, size_t LARGO, uint8_t* TRAMA)
+{  size_t Largo = DecodificarCOBS(CODIFICADA, LARGO, TRAMA);
+   if (Largo < 4) return 0;
+   Largo -= 2;
+   uint16_t Crc = TRAMA[Largo] | ((uint16_t)TRAMA[Largo + 1] << 8);
+   if (Crc != CrcPID(TRAMA, Largo)) return 0;
+   return Largo;
+}
+//-------------------------------------------------------------------------------------
+
+protocoloPID::protocoloPID(controlPID** LAZOS, uint8_t CANTIDAD)
+{  Lazos=LAZOS;
+   Cantidad=CANTIDAD;
+   Largo=0;
+   Desbordada=false;
+   TipoAcuse=0;
+   ResultadoAcuse=0;
+   Invalidas=0;
+}
+//-------------------------------------------------------------------------------------
+
+boolean protocoloPID::Recibir(uint8_t BYTE)
+{  if (BYTE != 0) {
+      if (Largo < sizeof(Recibidos)) Recibidos[Largo++] = BYTE;
+      else Desbordada = true;
+      return false;
+   }
+   // Fin de trama: sólo es inválida si no pasa COBS, el CRC o el largo. Una trama
+   // válida que no es una orden (datos, acuse) se ignora sin contarla.
+   boolean Responder = false;
+   if (Largo > 0) {
+      uint8_t Trama[sizeof(Recibidos)];
+      size_t LargoTrama = Desbordada ? 0 : AbrirTramaPID(Recibidos, Largo, Trama);
+      if (LargoTrama > 0) Responder = Aplicar(Trama, LargoTrama);
+      else Invalidas++;
+   }
+   Largo = 0;
+   Desbordada = false;
+   return Responder;
+}
+//-------------------------------------------------------------------------------------
+
+boolean protocoloPID::Aplicar(const uint8_t* TRAMA, size_t LARGO)
+// Las órdenes se aplican con las interrupciones deshabilitadas (el PID puede estar
+// corriendo en una y los campos de bits comparten bytes con los que escribe Calcular()).
+// Si hay dos núcleos noInterrupts() no excluye al otro: las órdenes se publican
+// (PublicarPID() y demás) y Controlar() las aplica en la próxima muestra; el acuse
+// es entonces 1 (publicada). Devuelve true si corresponde acusar la trama: toda
+// orden, incluso de tipo desconocido o con lazo o largo inválidos (ERROR_TRAMA_PID).
+{  TramaPID Tipo = (TramaPID)TRAMA[0];
+   uint8_t Lazo = TRAMA[1];
+   const uint8_t* Datos = TRAMA + 2;
+   size_t LargoDatos = LARGO - 2;
+   float Valores[3];
+   uint8_t Resultado = ERROR_TRAMA_PID;
+   if (Tipo == TramaPID::Datos || Tipo == TramaPID::Acuse) return false;   // No son órdenes: no se acusan
+   controlPID* PID = (Lazo < Cantidad) ? Lazos[Lazo] : NULL;
+   if (PID) {
+      switch (Tipo) {
+         case TramaPID::ConfigurarPID:
+            if (LargoDatos != 12) break;
+            memcpy(Valores, Datos, 12);
+#ifdef CONTROLPID_CONCURRENTE
+            PID->PublicarPID(Valores[0], Valores[1], Valores[2]);
+#else
+            noInterrupts();
+            PID->ConfigurarPID(Valores[0], Valores[1], Valores[2]);
+            interrupts();
+#endif
+            Resultado = 1;
+            break;
+         case TramaPID::LimitarSalida:
+            if (LargoDatos != 9) break;
+            memcpy(Valores, Datos + 1, 8);
+#ifdef CONTROLPID_CONCURRENTE
+            PID->PublicarLimitarSalida(Datos[0] != 0, Valores[0], Valores[1]);
+            Resultado = 1;
+#else
+            noInterrupts();
+            Resultado = PID->LimitarSalida(Datos[0] != 0, Valores[0], Valores[1]);
+            interrupts();
+#endif
+            break;
+         case TramaPID::LimitarIntegral:
+            if (LargoDatos != 1) break;
+#ifdef CONTROLPID_CONCURRENTE
+            PID->PublicarLimitarIntegral(Datos[0] != 0);
+            Resultado = 1;
+#else
+            noInterrupts();
+            Resultado = PID->LimitarIntegral(Datos[0] != 0);
+            interrupts();
+#endif
+            break;
+         case TramaPID::CondicionarIntegral:
+            if (LargoDatos != 1) break;
+#ifdef CONTROLPID_CONCURRENTE
+            PID->PublicarCondicionarIntegral(Datos[0] != 0);
+            Resultado = 1;
+#else
+            noInterrupts();
+            Resultado = PID->CondicionarIntegral(Datos[0] != 0);
+            interrupts();
+#endif
+            break;
+         default:
+            break;                   // Tipo desconocido: ERROR_TRAMA_PID, con cualquier lazo
+      }
+   }
+   TipoAcuse = (uint8_t)Tipo;
+   ResultadoAcuse = Resultado;
+   return true;
+}
+//-------------------------------------------------------------------------------------
+
+size_t protocoloPID::ArmarAcuse(uint8_t* TRAMA)
+{  uint8_t Datos[2] = {TipoAcuse, ResultadoAcuse};
+   return ArmarTramaPID(TramaPID::Acuse, 0, Datos, 2, TRAMA);
+}
+//-------------------------------------------------------------------------------------
+
+size_t protocoloPID::ArmarDatos(const muestraPID* MUESTRAS, uint8_t CANTIDAD, uint8_t* TRAMA)
+{  if (CANTIDAD > REGISTROS_TRAMA_PID) CANTIDAD = REGISTROS_TRAMA_PID;
+   return ArmarTramaPID(TramaPID::Datos, 0, MUESTRAS, CANTIDAD * sizeof(muestraPID), TRAMA);
+}
+//-------------------------------------------------------------------------------------
+
+uint32_t protocoloPID::ObtenerInvalidas()
+{  return Invalidas;
+}
+//-------------------------------------------------------------------------------------
@@ -0,0 +1,118 @@
+/****************************************************************************************
+  ControlPIDProtocolo.h
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Protocolo binario para ajustar PID en funcionamiento y transmitir su
+           telemetría por UART o USB CDC.
+           Trama (antes de codificar):
+              Tipo (1 byte)   TramaPID
+              Lazo (1 byte)   índice del PID (en tramas de datos: 0, el lazo va en
+                              cada registro)
+              Datos           según el tipo (ver abajo)
+              CRC (2 bytes)   CrcPID() de lo anterior, el byte bajo primero
+           La trama se codifica con COBS (no queda ningún byte 0) y se termina con un
+           0: un receptor que pierde bytes se resincroniza en el próximo 0.
+           Números en little-endian (float IEEE-754 de 4 bytes), como en AVR, ARM,
+           ESP32 y la PC.
+           Datos de cada tipo:
+              Datos                1 a 8 registros muestraPID (28 bytes c/u)
+              ConfigurarPID        Kp, Ti, Td (float)
+              LimitarSalida        activa (uint8_t), mínimo, máximo (float)
+              LimitarIntegral      activa (uint8_t)
+              CondicionarIntegral  activa (uint8_t)
+              Acuse                tipo recibido, resultado (uint8_t): lo que devolvió
+                                   la función (0 o 1; con CONTROLPID_CONCURRENTE, 1:
+                                   publicada), o ERROR_TRAMA_PID si el tipo, el
+                                   lazo o el largo no son válidos
+           Con 8 registros por trama se transmiten 230 bytes cada 8 muestras: a
+           2 Mbaud, unas 8000 muestras/s.
+-----------------------------------------------------------------------------------------
+  Uso:
+           controlPID* Lazos[] = {&PIDCorriente, &PIDVelocidad};
+           protocoloPID Protocolo(Lazos, 2);
+           ...
+           while (Serial.available()) {
+              if (Protocolo.Recibir(Serial.read())) {
+                 size_t Largo = Protocolo.ArmarAcuse(Trama);
+                 Serial.write(Trama, Largo);
+              }
+           }
+           En la PC: extras/host/decodificador.
+-----------------------------------------------------------------------------------------
+  Autor:   Colaboradores de ControlPID, sobre la biblioteca original de
+           Guillermo Caporaletti <gfcaporaletti@undav.edu.ar>
+           Sistemas de Control Automático (SCA)
+           Universidad Nacional de Avellaneda (UNDAV)
+  Fecha:   Octubre 2026
+  Version: 1.1
+****************************************************************************************/
+
+#ifndef CONTROLPIDPROTOCOLO_h
+#define CONTROLPIDPROTOCOLO_h
+#include "Arduino.h"
+#include "ControlPID.h"
+#include "ControlPIDTelemetria.h"
+
+/***************************************************************************************/
+
+enum class TramaPID : uint8_t        // Tipo de trama
+{  Datos = 0x01,                     // Registros de telemetría (del PID a la PC)
+   ConfigurarPID = 0x10,             // Órdenes (de la PC al PID)
+   LimitarSalida = 0x11,
+   LimitarIntegral = 0x12,
+   CondicionarIntegral = 0x13,
+   Acuse = 0x20                      // Respuesta a una orden
+};
+
+const uint8_t REGISTROS_TRAMA_PID = 8;         // Máximo de registros por trama de datos
+const uint8_t ERROR_TRAMA_PID = 0xFF;          // Resultado del acuse si la orden no es válida
+const size_t DATOS_TRAMA_PID = REGISTROS_TRAMA_PID * sizeof(muestraPID);  // Máximo de datos
+#define LARGO_TRAMA_PID(DATOS) ((DATOS) + 4 + ((DATOS) + 4) / 254 + 2)   // Bytes de la trama codificada
+
+/***************************************************************************************/
+
+size_t CodificarCOBS(const uint8_t* ENTRADA, size_t LARGO, uint8_t* SALIDA);
+                                     // Codifica con COBS (sin el 0 final). SALIDA debe tener lugar
+                                     // para LARGO + LARGO/254 + 1 bytes. Devuelve los bytes escritos.
+size_t DecodificarCOBS(const uint8_t* ENTRADA, size_t LARGO, uint8_t* SALIDA);
+                                     // Decodifica (ENTRADA sin el 0 final). Devuelve los bytes
+                                     // escritos, o 0 si la codificación no es válida.
+size_t ArmarTramaPID(TramaPID TIPO, uint8_t LAZO, const void* DATOS, size_t LARGO, uint8_t* TRAMA);
+                                     // Arma una trama completa (con CRC, COBS y el 0 final) en TRAMA,
+                                     // que debe tener LARGO_TRAMA_PID(LARGO) bytes. Devuelve su largo.
+size_t AbrirTramaPID(const uint8_t* CODIFICADA, size_t LARGO, uint8_t* TRAMA);
+                                     // Decodifica una trama (sin el 0 final) y verifica el CRC.
+                                     // Deja en TRAMA tipo, lazo y datos; devuelve su largo (sin el
+                                     // CRC) o 0 si la trama no es válida.
+
+/***************************************************************************************/
+
+class protocoloPID                   // Receptor de órdenes para un conjunto de PID
+{  private:
+      controlPID** Lazos;            // PID a los que se dirigen las órdenes
+      uint8_t Cantidad;
+      uint8_t Recibidos[LARGO_TRAMA_PID(16)];  // Trama en curso (las órdenes son cortas)
+      uint8_t Largo;                 // Bytes de la trama en curso
+      boolean Desbordada;            // La trama en curso no entra: se descarta hasta el próximo 0
+      uint8_t TipoAcuse;             // Última orden aplicada
+      uint8_t ResultadoAcuse;
+      uint32_t Invalidas;            // Tramas descartadas (CRC, largo, COBS)
+      boolean Aplicar(const uint8_t* TRAMA, size_t LARGO);
+
+   public:
+      protocoloPID(controlPID** LAZOS, uint8_t CANTIDAD);
+      boolean Recibir(uint8_t BYTE);                       // Procesa un byte recibido. Devuelve true al
+                                                           // completar una orden (aplicada o no, incluso de
+                                                           // tipo desconocido): corresponde enviar el acuse.
+                                                           // Las tramas de datos y acuses se ignoran.
+      size_t ArmarAcuse(uint8_t* TRAMA);                   // Acuse de la última orden en TRAMA
+                                                           // (LARGO_TRAMA_PID(2) bytes).
+      static size_t ArmarDatos(const muestraPID* MUESTRAS, uint8_t CANTIDAD, uint8_t* TRAMA);
+                                                           // Trama de datos con hasta REGISTROS_TRAMA_PID registros
+                                                           // (TRAMA: LARGO_TRAMA_PID(DATOS_TRAMA_PID) bytes).
+      uint32_t ObtenerInvalidas();                         // Tramas descartadas (COBS, CRC o largo).
+};
+
+/***************************************************************************************/
+
+#endif
@@ -0,0 +1,199 @@
+/****************************************************************************************
+  ControlPIDT.h
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Objeto de control PID con su estructura fijada al compilar.
+           Las acciones (P, PI, PD o PID) y el tipo de saturación se eligen como
+           parámetros de la plantilla, de modo que el compilador elimina las
+           preguntas sobre Ti, Td y los límites: Controlar() queda como código
+           en línea recta y sólo ocupa memoria de programa lo que se usa.
+           Para configurar todo en tiempo de ejecución usar controlPID.
+           ESCALAR es el tipo de entradas, salidas y constantes (float por omisión)
+           y ACUMULADOR el de la integral (por omisión, ESCALAR). Una integral más
+           ancha que la interfaz, controlPIDT<..., float, double>, sigue avanzando
+           con Ti grande y período corto, cuando los incrementos en float se
+           redondean a cero. Para punto fijo ver ControlPID_Q.h.
+-----------------------------------------------------------------------------------------
+  Uso:
+           controlPIDT<ModoPID::ProporcionalIntegral, SaturacionPID::Condicional>
+                 PID(KP, TI, 0, PERIODO);
+           PID.LimitarSalida(SMIN, SMAX);
+           ...
+           Salida = PID.Controlar(Error);   // cada PERIODO microsegundos
+           controlPIDT<ModoPID::Completo, SaturacionPID::Condicional, float, double>
+                 PIDLento(KP, 3600, TD, 1000);      // Ti de una hora a 1 kHz
+
+           El período de muestreo es fijo (como con controlPID::ConfigurarPeriodo()):
+           los coeficientes discretos se calculan al configurar.
+-----------------------------------------------------------------------------------------
+  Autor:   Colaboradores de ControlPID, sobre la biblioteca original de
+           Guillermo Caporaletti <gfcaporaletti@undav.edu.ar>
+           Sistemas de Control Automático (SCA)
+           Universidad Nacional de Avellaneda (UNDAV)
+  Fecha:   Octubre 2026
+  Version: 1.1
+****************************************************************************************/
+
+#ifndef CONTROLPIDT_h
+#define CONTROLPIDT_h
+#include "Arduino.h"
+#include <float.h>
+
+/***************************************************************************************/
+
+enum class ModoPID : uint8_t         // Acciones que se calculan
+{  Proporcional,                     // P   (no se llama "P", "PI"... porque Arduino define PI)
+   ProporcionalIntegral,             // PI
+   ProporcionalDerivativo,           // PD
+   Completo                          // PID
+};
+
+enum class SaturacionPID : uint8_t   // Límites y anti-enrole
+{  Ninguna,                          // Sin límites de salida
+   Salida,                           // Limita la salida (como LimitarSalida)
+   Integral,                         // Limita la salida y la integral (como LimitarIntegral)
+   Condicional,                      // Limita la salida y no integra si está saturada (como CondicionarIntegral)
+   IntegralCondicional               // Las dos anteriores
+};
+
+/***************************************************************************************/
+
+template <ModoPID MODO, SaturacionPID SATURACION, typename ESCALAR = float, typename ACUMULADOR = ESCALAR>
+class controlPIDT                    // Objeto para control PID especializado al compilar
+{  private:
+      static const boolean INTEGRA = (MODO==ModoPID::ProporcionalIntegral || MODO==ModoPID::Completo);
+      static const boolean DERIVA = (MODO==ModoPID::ProporcionalDerivativo || MODO==ModoPID::Completo);
+      static const boolean LIMITA_SALIDA = (SATURACION!=SaturacionPID::Ninguna);
+      static const boolean LIMITA_INTEGRAL = (SATURACION==SaturacionPID::Integral ||
+                                              SATURACION==SaturacionPID::IntegralCondicional);
+      static const boolean CONDICIONA_INTEGRAL = (SATURACION==SaturacionPID::Condicional ||
+                                                  SATURACION==SaturacionPID::IntegralCondicional);
+      ESCALAR Salida;                // La señal de control que va al actuador
+      ESCALAR Proporcional;          // Componente proporcional de la salida
+      ACUMULADOR Integral;           // Componente integral
+      ESCALAR Derivativo;            // Componente derivativa
+      ESCALAR Kp;                    // Constante proporcional
+      ESCALAR CoefIntegral;          // Kp*Ts/(2*Ti)
+      ESCALAR CoefDerivativo;        // Kp*Td/Ts
+      unsigned long Periodo;         // Período de muestreo (en microsegundos)
+      ESCALAR ErrorAnterior;         // Señal de error anterior
+      boolean PrimeraMuestra;        // Indica que no hay muestra anterior (no integra ni deriva)
+      ESCALAR SalidaMax;             // Límite superior de la salida (y de la integral)
+      ESCALAR SalidaMin;             // Límite inferior de la salida
+
+   public:
+      controlPIDT(ESCALAR KP, ESCALAR TI, ESCALAR TD, unsigned long PERIODO);
+                                                           // KP: Constante de proporcionalidad (puede ser negativo)
+                                                           // TI: Tiempo de integración (se ignora sin acción I)
+                                                           // TD: Tiempo de derivación (se ignora sin acción D)
+                                                           // PERIODO: Período de muestreo en microsegundos
+      void ConfigurarPID(ESCALAR KP, ESCALAR TI, ESCALAR TD); // Cambia constantes, mismo período.
+      void ConfigurarPID(ESCALAR KP, ESCALAR TI, ESCALAR TD, unsigned long PERIODO);
+      boolean LimitarSalida(ESCALAR SMIN, ESCALAR SMAX);   // Establece los límites de salida.
+                                                           // Devuelve false (y no los cambia) si SMIN>=SMAX.
+      ESCALAR Controlar(ESCALAR ERROR);                    // Calcula señal de control en función del error.
+      void Apagar();                                       // Apaga el PID y resetea valores.
+      ACUMULADOR ObtenerIntegral()  { return Integral; }
+      ESCALAR ObtenerProporcional() { return Proporcional; }
+      ESCALAR ObtenerDerivativo()   { return Derivativo; }
+      ESCALAR ObtenerSalida()       { return Salida; }
+      unsigned long ObtenerPeriodo() { return Periodo; }
+};
+
+/***************************************************************************************/
+// Implementación (en el encabezado por tratarse de una plantilla)
+/***************************************************************************************/
+
+template <ModoPID MODO, SaturacionPID SATURACION, typename ESCALAR, typename ACUMULADOR>
+controlPIDT<MODO, SATURACION, ESCALAR, ACUMULADOR>::controlPIDT(ESCALAR KP, ESCALAR TI, ESCALAR TD, unsigned long PERIODO)
+// Sin límites establecidos se satura en ±FLT_MAX (es decir, no se satura).
+{  SalidaMax=FLT_MAX;
+   SalidaMin=-FLT_MAX;
+   ConfigurarPID(KP, TI, TD, PERIODO);
+}
+//-------------------------------------------------------------------------------------
+
+template <ModoPID MODO, SaturacionPID SATURACION, typename ESCALAR, typename ACUMULADOR>
+void controlPIDT<MODO, SATURACION, ESCALAR, ACUMULADOR>::ConfigurarPID(ESCALAR KP, ESCALAR TI, ESCALAR TD)
+{  ConfigurarPID(KP, TI, TD, Periodo);
+}
+//-------------------------------------------------------------------------------------
+
+template <ModoPID MODO, SaturacionPID SATURACION, typename ESCALAR, typename ACUMULADOR>
+void controlPIDT<MODO, SATURACION, ESCALAR, ACUMULADOR>::ConfigurarPID(ESCALAR KP, ESCALAR TI, ESCALAR TD, unsigned long PERIODO)
+// Calcula los coeficientes discretos. Resetea valores de integración.
+{  ESCALAR Ts = PERIODO / (ESCALAR)1e6;
+   Periodo = PERIODO;
+   Kp = KP;
+   CoefIntegral = (INTEGRA && TI!=0) ? KP*Ts/(2*TI) : 0;
+   CoefDerivativo = (DERIVA && PERIODO>0) ? KP*TD/Ts : 0;
+   Apagar();
+}
+//-------------------------------------------------------------------------------------
+
+template <ModoPID MODO, SaturacionPID SATURACION, typename ESCALAR, typename ACUMULADOR>
+boolean controlPIDT<MODO, SATURACION, ESCALAR, ACUMULADOR>::LimitarSalida(ESCALAR SMIN, ESCALAR SMAX)
+{  if (SMIN>=SMAX) return false;
+   SalidaMin=SMIN;
+   SalidaMax=SMAX;
+   return true;
+}
+//-------------------------------------------------------------------------------------
+
+template <ModoPID MODO, SaturacionPID SATURACION, typename ESCALAR, typename ACUMULADOR>
+ESCALAR controlPIDT<MODO, SATURACION, ESCALAR, ACUMULADOR>::Controlar(ESCALAR ERROR)
+// Mismo cálculo que controlPID::Controlar() con período fijo.
+// Las condiciones sobre constantes de la plantilla las resuelve el compilador.
+{  boolean SalidaEstaSaturada = false;
+
+   // PROPORCIONAL --------------------------------------------------------------
+   Proporcional = Kp*ERROR;
+
+   // DERIVATIVO ----------------------------------------------------------------
+   if (DERIVA) {
+      Derivativo = PrimeraMuestra ? 0 : CoefDerivativo*(ERROR-ErrorAnterior);
+   }
+
+   // ¿Debo saturar salida? -----------------------------------------------------
+   if (CONDICIONA_INTEGRAL) {
+      Salida = (ESCALAR)(Proporcional + Integral + Derivativo);
+      SalidaEstaSaturada = (Salida > SalidaMax) || (Salida < SalidaMin);
+   }
+
+   // INTEGRAL ------------------------------------------------------------------
+   if (INTEGRA && !PrimeraMuestra) {
+      if (!CONDICIONA_INTEGRAL || !SalidaEstaSaturada) {
+        Integral += CoefIntegral*(ERROR+ErrorAnterior);
+      }
+      if (LIMITA_INTEGRAL) {
+        Integral = min(Integral, (ACUMULADOR)SalidaMax);
+        Integral = max(Integral, (ACUMULADOR)SalidaMin);
+      }
+   }
+
+   // Cálculo final completo:
+   Salida = (ESCALAR)(Proporcional + Integral + Derivativo);
+   if (LIMITA_SALIDA) {
+      Salida = min(Salida, SalidaMax);
+      Salida = max(Salida, SalidaMin);
+   }
+   PrimeraMuestra = false;
+   ErrorAnterior = ERROR;
+   return Salida;
+}
+//-------------------------------------------------------------------------------------
+
+template <ModoPID MODO, SaturacionPID SATURACION, typename ESCALAR, typename ACUMULADOR>
+void controlPIDT<MODO, SATURACION, ESCALAR, ACUMULADOR>::Apagar()
+// No se modifican las constantes ni los límites.
+{  PrimeraMuestra=true;
+   ErrorAnterior=0;
+   Integral=0;
+   Proporcional=0;
+   Derivativo=0;
+   Salida=0;
+}
+
+/***************************************************************************************/
+
+#endif
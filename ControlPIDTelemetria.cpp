@@ -0,0 +1,109 @@
+/***********************************************************************************
+  ControlPIDTelemetria.cpp
+-----------------------------------------------------------------------------------
+  Descripción:
+           Cola de telemetría de controlPID (un productor, un consumidor).
+           Los índices avanzan sin límite (desbordan solos) y se enmascaran al
+           acceder: la cantidad ocupada es siempre Escritura-Lectura.
+-----------------------------------------------------------------------------------
+  Autor:   Colaboradores de ControlPID, sobre la biblioteca original de
+           Guillermo Caporaletti <gfcaporaletti@undav.edu.ar>
+           Sistemas de Control Automático (SCA)
+           Universidad Nacional de Avellaneda (UNDAV)
+  Fecha:   Octubre 2026
+  Version: 1.1
+***********************************************************************************/
+
+#include "Arduino.h"
+#include "ControlPIDTelemetria.h"
+
+/**************************************************************************************/
+
+colaPID::colaPID(muestraPID* MUESTRAS, indiceColaPID CAPACIDAD)
+{  Muestras=MUESTRAS;
+   Mascara=CAPACIDAD-1;
+   Escritura=0;
+   Lectura=0;
+   Perdidas=0;
+   Secuencia=0;
+}
+//-------------------------------------------------------------------------------------
+
+boolean colaPID::Registrar(uint8_t LAZO, uint32_t TIEMPO, float ERROR, float PROPORCIONAL,
+                           float INTEGRAL, float DERIVATIVO, float SALIDA, uint8_t INDICADORES)
+{  indiceColaPID Indice = Escritura;
+   Secuencia++;
+   if ((indiceColaPID)(Indice - Lectura) > Mascara) {
+      // Llena: el consumidor no alcanzó a vaciarla.
+      Perdidas++;
+      return false;
+   }
+   muestraPID& Muestra = Muestras[Indice & Mascara];
+   Muestra.Tiempo = TIEMPO;
+   Muestra.Error = ERROR;
+   Muestra.Proporcional = PROPORCIONAL;
+   Muestra.Integral = INTEGRAL;
+   Muestra.Derivativo = DERIVATIVO;
+   Muestra.Salida = SALIDA;
+   Muestra.Secuencia = Secuencia - 1;
+   Muestra.Lazo = LAZO;
+   Muestra.Indicadores = INDICADORES;
+   BarreraPID();                     // El registro completo antes de publicarlo
+   Escritura = Indice + 1;
+   return true;
+}
+//-------------------------------------------------------------------------------------
+
+indiceColaPID colaPID::Disponibles()
+{  return Escritura - Lectura;
+}
+//-------------------------------------------------------------------------------------
+
+const muestraPID* colaPID::Bloque(indiceColaPID& CANTIDAD)
+// Hasta el final del arreglo: si la cola da la vuelta, el resto queda para el próximo bloque.
+{  indiceColaPID Indice = Lectura;
+   indiceColaPID Ocupados = (indiceColaPID)(Escritura - Indice);
+   BarreraPID();                     // Leo los registros después de ver el índice
+   indiceColaPID HastaElFinal = Mascara + 1 - (Indice & Mascara);
+   CANTIDAD = (Ocupados < HastaElFinal) ? Ocupados : HastaElFinal;
+   return &Muestras[Indice & Mascara];
+}
+//-------------------------------------------------------------------------------------
+
+void colaPID::Liberar(indiceColaPID CANTIDAD)
+{  BarreraPID();                     // Terminé de leer antes de devolver el lugar
+   Lectura = Lectura + CANTIDAD;
+}
+//-------------------------------------------------------------------------------------
+
+indiceColaPID colaPID::Leer(muestraPID* DESTINO, indiceColaPID MAXIMO)
+{  indiceColaPID Leidos = 0;
+   while (Leidos < MAXIMO) {
+      indiceColaPID Cantidad;
+      const muestraPID* Origen = Bloque(Cantidad);
+      if (Cantidad == 0) break;
+      if (Cantidad > MAXIMO - Leidos) Cantidad = MAXIMO - Leidos;
+      memcpy(DESTINO + Leidos, Origen, Cantidad * sizeof(muestraPID));
+      Liberar(Cantidad);
+      Leidos += Cantidad;
+   }
+   return Leidos;
+}
+//-------------------------------------------------------------------------------------
+
+uint32_t colaPID::ObtenerPerdidas()
+// En AVR leer 32 bits lleva cuatro instrucciones y el productor puede ser una
+// interrupción: se lee con las interrupciones bloqueadas, conservando el estado
+// anterior (puede llamarse desde otra interrupción).
+{
+#if defined(__AVR__)
+   uint8_t Estado = SREG;
+   cli();
+   uint32_t Cantidad = Perdidas;
+   SREG = Estado;
+   return Cantidad;
+#else
+   return Perdidas;                           // 32 bits: lectura atómica
+#endif
+}
+//-------------------------------------------------------------------------------------
@@ -0,0 +1,108 @@
+/****************************************************************************************
+  ControlPIDTelemetria.h
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Cola circular sin bloqueo (un productor y un consumidor) de registros
+           binarios de tamaño fijo con los valores internos de controlPID en cada
+           muestra. El productor es Controlar() (normalmente en una interrupción);
+           el consumidor, loop(), que los vacía en bloque por Serial (o DMA) sin
+           imprimir en ASCII dentro del lazo.
+           Si la cola está llena el registro se descarta y se cuenta como perdido:
+           el PID nunca espera al consumidor.
+           Varios lazos pueden compartir una cola (ver ConectarTelemetria()): cada
+           registro lleva el número y el tiempo de su lazo.
+-----------------------------------------------------------------------------------------
+  Uso:
+           telemetriaPID<64> Telemetria;
+           PID.ConectarTelemetria(&Telemetria);
+           ...
+           // En loop(): envío los registros contiguos sin copiarlos.
+           indiceColaPID Cantidad;
+           const muestraPID* Bloque = Telemetria.Bloque(Cantidad);
+           Serial.write((const uint8_t*)Bloque, Cantidad * sizeof(muestraPID));
+           Telemetria.Liberar(Cantidad);
+-----------------------------------------------------------------------------------------
+  Autor:   Colaboradores de ControlPID, sobre la biblioteca original de
+           Guillermo Caporaletti <gfcaporaletti@undav.edu.ar>
+           Sistemas de Control Automático (SCA)
+           Universidad Nacional de Avellaneda (UNDAV)
+  Fecha:   Octubre 2026
+  Version: 1.1
+****************************************************************************************/
+
+#ifndef CONTROLPIDTELEMETRIA_h
+#define CONTROLPIDTELEMETRIA_h
+#include "Arduino.h"
+#include "ControlPID.h"
+
+/***************************************************************************************/
+
+#if defined(__AVR__)
+typedef uint8_t indiceColaPID;       // Índices de la cola: su lectura debe ser atómica
+#else
+typedef uint16_t indiceColaPID;
+#endif
+
+/***************************************************************************************/
+
+struct muestraPID                    // Registro de una muestra (28 bytes, sin relleno)
+{  uint32_t Tiempo;                  // Tiempo del lazo (us): suma de sus intervalos medidos, sin
+                                     // recortar demoras, desde que se lo conectó a la cola
+   float Error;
+   float Proporcional;
+   float Integral;
+   float Derivativo;
+   float Salida;
+   uint16_t Secuencia;               // Número de registro (un salto indica registros perdidos)
+   uint8_t Lazo;                     // Número de lazo (ver ConectarTelemetria())
+   uint8_t Indicadores;              // Bits SATURADA, INTEGRAL_BLOQUEADA, PRIMERA
+
+   static constexpr uint8_t SATURADA = 0x01;             // Se recortó la salida (límites o variación)
+   static constexpr uint8_t INTEGRAL_BLOQUEADA = 0x02;   // CondicionaIntegral no integró
+   static constexpr uint8_t PRIMERA = 0x04;              // Sin muestra anterior: no integró ni derivó
+};
+
+/***************************************************************************************/
+
+class colaPID                        // Cola de registros sobre un arreglo externo
+{  private:
+      muestraPID* Muestras;          // Arreglo de CAPACIDAD registros
+      indiceColaPID Mascara;         // CAPACIDAD-1 (CAPACIDAD es potencia de 2)
+      volatile indiceColaPID Escritura;  // Registros escritos (sólo lo modifica el productor)
+      volatile indiceColaPID Lectura;    // Registros leídos (sólo lo modifica el consumidor)
+      volatile uint32_t Perdidas;    // Registros descartados por cola llena
+      uint16_t Secuencia;            // Próximo número de registro
+
+   public:
+      colaPID(muestraPID* MUESTRAS, indiceColaPID CAPACIDAD);
+                                                           // CAPACIDAD debe ser potencia de 2
+                                                           // (hasta 128 en AVR, 32768 en las demás).
+      boolean Registrar(uint8_t LAZO, uint32_t TIEMPO, float ERROR, float PROPORCIONAL,
+                        float INTEGRAL, float DERIVATIVO, float SALIDA, uint8_t INDICADORES);
+                                                           // Productor: escribe el registro en su lugar en la
+                                                           // cola. Devuelve false si estaba llena.
+      indiceColaPID Disponibles();                         // Consumidor: registros para leer.
+      indiceColaPID Leer(muestraPID* DESTINO, indiceColaPID MAXIMO);
+                                                           // Consumidor: copia hasta MAXIMO registros.
+      const muestraPID* Bloque(indiceColaPID& CANTIDAD);   // Consumidor: registros contiguos disponibles (sin
+                                                           // copiarlos). Se deben liberar después de usarlos.
+      void Liberar(indiceColaPID CANTIDAD);                // Consumidor: descarta CANTIDAD registros ya usados.
+      uint32_t ObtenerPerdidas();                          // Registros descartados por cola llena.
+                                                           // Se puede llamar mientras produce una interrupción.
+};
+
+/***************************************************************************************/
+
+template <indiceColaPID N>
+class telemetriaPID : public colaPID // Cola de telemetría con su propio arreglo de N registros
+{  static_assert(N > 0 && (N & (N-1)) == 0, "N debe ser potencia de 2");
+   static_assert(N <= (indiceColaPID)(~(indiceColaPID)0) / 2 + 1, "N demasiado grande para indiceColaPID");
+   private:
+      muestraPID Almacen[N];
+   public:
+      telemetriaPID() : colaPID(Almacen, N) {}
+};
+
+/***************************************************************************************/
+
+#endif
@@ -0,0 +1,323 @@
+/****************************************************************************************
+  ControlPID_Q.h
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Objeto de control PID en aritmética de punto fijo (formato Q).
+           Misma interfaz que controlPID, pero sin operaciones de punto flotante
+           dentro de Controlar(). Pensado para microcontroladores sin FPU (ej.: ATmega328).
+           Limita efecto enrole mediante saturación y bloqueo de integración.
+           La integral se acumula con saturación (nunca desborda).
+-----------------------------------------------------------------------------------------
+  Uso:
+           controlPID_Q<T, FRAC> donde T es el tipo entero de las señales (int16_t o
+           int32_t) y FRAC la cantidad de bits fraccionarios. Ejemplos:
+              controlPID_Q15     -> int16_t con 15 bits fraccionarios (señales en [-1,1))
+              controlPID_Q16_16  -> int32_t con 16 bits fraccionarios
+           En AVR conviene int16_t: los productos se hacen en 32 bits. Con int32_t los
+           productos se hacen en 64 bits, que en AVR también se emulan por software.
+
+           El período de muestreo es fijo y se indica al configurar (en microsegundos):
+           así los coeficientes discretos se calculan una sola vez y Controlar() no
+           llama a micros() ni divide. Se debe llamar a Controlar() cada PERIODO.
+
+           La conversión float <-> Q se hace con AFijo() y AFlotante().
+           Kp y Kp*Td/Ts deben ser representables en el formato elegido: se saturan
+           al máximo (en Q15 no hay Kp >= 1: queda en 1-2^-15; para ganancias mayores
+           usar Q16_16 o escalar las señales) y uno menor a 2^-FRAC se redondea a cero.
+           Kp*Ts/(2*Ti) suele ser mucho menor que 1: se guarda con hasta FRAC bits
+           fraccionarios más (escala propia), de modo que la integral avanza mientras
+           Kp*Ts/(2*Ti) >= 2^-(2*FRAC) (en Q15, unos 1e-9; en Q16_16, 2e-10).
+-----------------------------------------------------------------------------------------
+  Autor:   Colaboradores de ControlPID, sobre la biblioteca original de
+           Guillermo Caporaletti <gfcaporaletti@undav.edu.ar>
+           Sistemas de Control Automático (SCA)
+           Universidad Nacional de Avellaneda (UNDAV)
+  Fecha:   Octubre 2026
+  Version: 1.1
+****************************************************************************************/
+
+#ifndef CONTROLPID_Q_h
+#define CONTROLPID_Q_h
+#include "Arduino.h"
+
+/***************************************************************************************/
+
+template <typename T> struct anchoPID_Q;   // Tipo ancho para productos y acumulación
+
+template <> struct anchoPID_Q<int16_t>
+{  typedef int32_t Tipo;
+   static const int16_t MAXIMO = INT16_MAX;
+   static const int16_t MINIMO = INT16_MIN;
+};
+
+template <> struct anchoPID_Q<int32_t>
+{  typedef int64_t Tipo;
+   static const int32_t MAXIMO = INT32_MAX;
+   static const int32_t MINIMO = INT32_MIN;
+};
+
+/***************************************************************************************/
+
+template <typename T, uint8_t FRAC>
+class controlPID_Q                   // Objeto para control PID en punto fijo
+{  private:
+      typedef typename anchoPID_Q<T>::Tipo Ancho;
+      T Salida;                      // La señal de control que va al actuador (en Q)
+      T Proporcional;                // Componente proporcional de la salida
+      T Integral;                    // Componente integral
+      T Derivativo;                  // Componente derivativa
+      T Kp;                          // Constante proporcional (en Q)
+      T CoefIntegral;                // Kp*Ts/(2*Ti), con FRAC+EscalaIntegral bits fraccionarios
+      uint8_t EscalaIntegral;        // Bits fraccionarios de CoefIntegral además de FRAC (hasta FRAC)
+      T CoefDerivativo;              // Kp*Td/Ts (en Q)
+      Ancho Acumulador;              // Integral con 2*FRAC bits fraccionarios:
+                                     // no se pierden incrementos menores a 1 LSB.
+      unsigned long Periodo;         // Período de muestreo (en microsegundos)
+      T ErrorAnterior;               // Señal de error anterior
+      boolean PrimeraMuestra;        // Indica que no hay muestra anterior (no integra ni deriva)
+      boolean LimitaSalida;          // Indica si establecimos límites superior e inferior a la salida
+      boolean LimitaIntegral;        // Indica si establecimos límites en la integral (los de la salida)
+      boolean CondicionaIntegral;    // Condiciona la integral a que la salida no esté saturada.
+      T SalidaMax;                   // Límite superior de la salida (y de la integral)
+      T SalidaMin;                   // Límite inferior de la salida
+
+      static const Ancho UNO = (Ancho)1 << FRAC;                    // 1.0 en Q
+      static const Ancho ACUMULADOR_MAX = (Ancho)anchoPID_Q<T>::MAXIMO * UNO;
+      static const Ancho ACUMULADOR_MIN = (Ancho)anchoPID_Q<T>::MINIMO * UNO;
+
+      static T Saturar(Ancho VALOR);                       // Recorta VALOR al rango de T.
+      static T Producto(T COEF, Ancho VALOR);              // COEF*VALOR en Q, saturado.
+
+   public:
+      controlPID_Q(float KP, float TI, float TD, unsigned long PERIODO);
+                                                           // Constructor con lo mínimo:
+                                                           // KP: Constante de proporcionalidad (puede ser negativo)
+                                                           // TI: Tiempo de integración (si es 0, no integra)
+                                                           // TD: Tiempo de derivación (si es 0 no deriva)
+                                                           // PERIODO: Período de muestreo en microsegundos
+      void ConfigurarPID(float KP, float TI, float TD);    // Cambia constantes, mismo período.
+      void ConfigurarPID(float KP, float TI, float TD, unsigned long PERIODO);
+                                                           // Mismos parámetros que el constructor.
+      boolean LimitarSalida(boolean RESPUESTA, T SMIN, T SMAX);  // Configura los límites de salida (en Q).
+      boolean LimitarSalida(boolean RESPUESTA);            // Activa o desactiva los límites de salida.
+      boolean LimitarSalida();                             // Indica si el límite de salida está activado.
+      boolean LimitarIntegral(boolean RESPUESTA);          // Activa o desactiva el límite de integración.
+      boolean LimitarIntegral();                           // Indica si el límite de integración está activado.
+      boolean CondicionarIntegral(boolean RESPUESTA);      // Activa o desactiva el condicional de integración.
+      boolean CondicionarIntegral();                       // Indica si el condicional de integración está activado.
+      T Controlar(T ERROR);                                // Calcula señal de control (en Q) en función del error.
+      void Apagar();                                       // Apaga el PID y resetea valores.
+      T ObtenerIntegral()     { return Integral; }
+      T ObtenerProporcional() { return Proporcional; }
+      T ObtenerDerivativo()   { return Derivativo; }
+      T ObtenerSalida()       { return Salida; }
+      unsigned long ObtenerPeriodo() { return Periodo; }
+
+      static T AFijo(float VALOR);                         // Convierte float a Q (redondea y satura).
+      static float AFlotante(T VALOR);                     // Convierte Q a float.
+};
+
+typedef controlPID_Q<int16_t, 15> controlPID_Q15;         // Señales en [-1,1), resolución 2^-15
+typedef controlPID_Q<int32_t, 16> controlPID_Q16_16;      // Señales en [-32768,32768), resolución 2^-16
+
+/***************************************************************************************/
+// Implementación (en el encabezado por tratarse de una plantilla)
+/***************************************************************************************/
+
+template <typename T, uint8_t FRAC>
+controlPID_Q<T, FRAC>::controlPID_Q(float KP, float TI, float TD, unsigned long PERIODO)
+// Constructor: incluye configuración inicial del PID y valores predeterminados.
+{  SalidaMax=0;
+   SalidaMin=0;
+   ConfigurarPID(KP, TI, TD, PERIODO);
+   LimitaSalida=false;
+   LimitaIntegral=false;
+   CondicionaIntegral=false;
+}
+//-------------------------------------------------------------------------------------
+
+template <typename T, uint8_t FRAC>
+void controlPID_Q<T, FRAC>::ConfigurarPID(float KP, float TI, float TD)
+// Cambia las constantes manteniendo el período de muestreo.
+{  ConfigurarPID(KP, TI, TD, Periodo);
+}
+//-------------------------------------------------------------------------------------
+
+template <typename T, uint8_t FRAC>
+void controlPID_Q<T, FRAC>::ConfigurarPID(float KP, float TI, float TD, unsigned long PERIODO)
+// Calcula los coeficientes discretos (única parte en punto flotante).
+// Sirve para cambiar configuración inicial, sin modificar límites y condicional.
+// Resetea valores de integración.
+{  float Ts = PERIODO / 1e6;
+   Periodo = PERIODO;
+   Kp = AFijo(KP);
+   // CoefIntegral con la mayor escala que no lo sature: en Q se redondearía a cero
+   // con Ts/Ti chico y la integral no avanzaría.
+   float Coef = (TI!=0) ? KP*Ts/(2*TI) : 0;
+   float Escalado = fabs(Coef);
+   EscalaIntegral = 0;
+   while (EscalaIntegral < FRAC && Escalado*2*UNO < anchoPID_Q<T>::MAXIMO) {
+      Escalado *= 2;
+      EscalaIntegral++;
+   }
+   CoefIntegral = AFijo(Coef * (float)((Ancho)1 << EscalaIntegral));
+   CoefDerivativo = (TD!=0 && PERIODO>0) ? AFijo(KP*TD/Ts) : 0;
+   Apagar();
+}
+//-------------------------------------------------------------------------------------
+
+template <typename T, uint8_t FRAC>
+boolean controlPID_Q<T, FRAC>::LimitarSalida()
+{  return LimitaSalida;
+}
+//-------------------------------------------------------------------------------------
+
+template <typename T, uint8_t FRAC>
+boolean controlPID_Q<T, FRAC>::LimitarSalida(boolean RESPUESTA)
+// No permite activar límites si antes no fueron establecidos.
+{  LimitaSalida=RESPUESTA;
+   if (SalidaMax==0 && SalidaMin==0) LimitaSalida=false;
+   return LimitaSalida;
+}
+//-------------------------------------------------------------------------------------
+
+template <typename T, uint8_t FRAC>
+boolean controlPID_Q<T, FRAC>::LimitarSalida(boolean RESPUESTA, T SMIN, T SMAX)
+// Configura si limitará la salida entre SMAX y SMIN.
+// No activa con SMIN=SMAX ni con SMIN>SMAX.
+{  SalidaMax=SMAX;
+   SalidaMin=SMIN;
+   LimitaSalida=RESPUESTA;
+   if (SalidaMax<=SalidaMin) LimitaSalida=false;
+   return LimitaSalida;
+}
+//-------------------------------------------------------------------------------------
+
+template <typename T, uint8_t FRAC>
+boolean controlPID_Q<T, FRAC>::LimitarIntegral()
+{  return LimitaIntegral;
+}
+//-------------------------------------------------------------------------------------
+
+template <typename T, uint8_t FRAC>
+boolean controlPID_Q<T, FRAC>::LimitarIntegral(boolean RESPUESTA)
+// Limita el integrador entre los mismos márgenes de la salida.
+{  LimitaIntegral=RESPUESTA;
+   if (SalidaMax==SalidaMin) LimitaIntegral=false;
+   return LimitaIntegral;
+}
+//-------------------------------------------------------------------------------------
+
+template <typename T, uint8_t FRAC>
+boolean controlPID_Q<T, FRAC>::CondicionarIntegral()
+{  return CondicionaIntegral;
+}
+//-------------------------------------------------------------------------------------
+
+template <typename T, uint8_t FRAC>
+boolean controlPID_Q<T, FRAC>::CondicionarIntegral(boolean RESPUESTA)
+// Pausa la integración cuando la salida está saturada.
+// Deben haberse preestablecido los límites de salida.
+{  CondicionaIntegral = RESPUESTA;
+   if (!LimitaSalida) CondicionaIntegral=false;
+   return CondicionaIntegral;
+}
+//-------------------------------------------------------------------------------------
+
+template <typename T, uint8_t FRAC>
+T controlPID_Q<T, FRAC>::Controlar(T ERROR)
+// Calcula Salida en función de la señal error y los parámetros del PID.
+// Sólo sumas, productos enteros y desplazamientos.
+{  boolean SalidaEstaSaturada = false;
+
+   // PROPORCIONAL --------------------------------------------------------------
+   Proporcional = Producto(Kp, ERROR);
+
+   // DERIVATIVO ----------------------------------------------------------------
+   if (!PrimeraMuestra && CoefDerivativo!=0) {
+      Derivativo = Producto(CoefDerivativo, (Ancho)ERROR - ErrorAnterior);
+   } else {
+      Derivativo = 0;
+   }
+
+   // ¿Debo saturar salida? -----------------------------------------------------
+   Salida = Saturar((Ancho)Proporcional + Integral + Derivativo);
+   if (LimitaSalida && ((Salida > SalidaMax) || (Salida < SalidaMin))) {
+      SalidaEstaSaturada = true;
+   }
+
+   // INTEGRAL ------------------------------------------------------------------
+   if (!PrimeraMuestra && CoefIntegral!=0) {
+      if (!CondicionaIntegral || !SalidaEstaSaturada) {
+        // Incremento en 2*FRAC bits fraccionarios (se descarta la escala propia del
+        // coeficiente). Suma con saturación:
+        Ancho Incremento = ((Ancho)CoefIntegral * ((Ancho)ERROR + ErrorAnterior)) >> EscalaIntegral;
+        if (Incremento > 0) {
+          Acumulador = (Acumulador > ACUMULADOR_MAX - Incremento) ? ACUMULADOR_MAX : Acumulador + Incremento;
+        } else {
+          Acumulador = (Acumulador < ACUMULADOR_MIN - Incremento) ? ACUMULADOR_MIN : Acumulador + Incremento;
+        }
+      }
+      if (LimitaIntegral) {
+        Acumulador = min(Acumulador, (Ancho)SalidaMax * UNO);
+        Acumulador = max(Acumulador, (Ancho)SalidaMin * UNO);
+      }
+      Integral = (T)(Acumulador >> FRAC);
+   }
+
+   // Cálculo final completo:
+   Salida = Saturar((Ancho)Proporcional + Integral + Derivativo);
+   if (LimitaSalida) {
+      Salida = min(Salida, SalidaMax);
+      Salida = max(Salida, SalidaMin);
+   }
+   ErrorAnterior = ERROR;
+   PrimeraMuestra = false;
+   return Salida;
+}
+//-------------------------------------------------------------------------------------
+
+template <typename T, uint8_t FRAC>
+void controlPID_Q<T, FRAC>::Apagar()
+{  PrimeraMuestra=true;
+   ErrorAnterior=0;
+   Acumulador=0;
+   Integral=0;
+   Proporcional=0;
+   Derivativo=0;
+   Salida=0;
+}
+//-------------------------------------------------------------------------------------
+
+template <typename T, uint8_t FRAC>
+T controlPID_Q<T, FRAC>::Saturar(Ancho VALOR)
+{  if (VALOR > anchoPID_Q<T>::MAXIMO) return anchoPID_Q<T>::MAXIMO;
+   if (VALOR < anchoPID_Q<T>::MINIMO) return anchoPID_Q<T>::MINIMO;
+   return (T)VALOR;
+}
+//-------------------------------------------------------------------------------------
+
+template <typename T, uint8_t FRAC>
+T controlPID_Q<T, FRAC>::Producto(T COEF, Ancho VALOR)
+// VALOR no supera el doble del rango de T, así que el producto entra en Ancho.
+{  return Saturar(((Ancho)COEF * VALOR) >> FRAC);
+}
+//-------------------------------------------------------------------------------------
+
+template <typename T, uint8_t FRAC>
+T controlPID_Q<T, FRAC>::AFijo(float VALOR)
+{  float Escalado = VALOR * UNO;
+   if (Escalado >= anchoPID_Q<T>::MAXIMO) return anchoPID_Q<T>::MAXIMO;
+   if (Escalado <= anchoPID_Q<T>::MINIMO) return anchoPID_Q<T>::MINIMO;
+   return (T)((Escalado < 0) ? Escalado - 0.5 : Escalado + 0.5);
+}
+//-------------------------------------------------------------------------------------
+
+template <typename T, uint8_t FRAC>
+float controlPID_Q<T, FRAC>::AFlotante(T VALOR)
+{  return (float)VALOR / UNO;
+}
+
+/***************************************************************************************/
+
+#endif
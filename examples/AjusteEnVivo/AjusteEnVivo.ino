@@ -0,0 +1,59 @@
+/****************************************************************************************
+  AjusteEnVivo.ino
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Telemetría y ajuste del PID con el protocolo binario de ControlPIDProtocolo.h.
+           Envía tramas de 8 registros (ver muestraPID) y recibe órdenes para cambiar
+           constantes y límites, que responde con un acuse.
+           En la PC:
+              ./decodificador /dev/ttyACM0 > registro.csv
+              ./decodificador --pid 0 0.8 1.5 0.01 > /dev/ttyACM0
+****************************************************************************************/
+
+#include <ControlPID.h>
+#include <ControlPIDTelemetria.h>
+#include <ControlPIDProtocolo.h>
+
+const unsigned long PERIODO = 500;   // Período de muestreo (us): 2 kHz
+const int PIN_SENSOR = A0;
+const int PIN_ACTUADOR = 9;
+const float REFERENCIA = 512;
+
+controlPID PID(0.5, 2.0, 0.01);
+controlPID* Lazos[] = {&PID};
+protocoloPID Protocolo(Lazos, 1);
+telemetriaPID<32> Telemetria;
+uint8_t Trama[LARGO_TRAMA_PID(DATOS_TRAMA_PID)];
+
+void setup()
+{  Serial.begin(2000000);
+   PID.ConfigurarPeriodo(PERIODO);
+   PID.LimitarSalida(true, 0, 255);
+   PID.CondicionarIntegral(true);
+   PID.ConectarTelemetria(&Telemetria);
+}
+
+void loop()
+{  static unsigned long Proximo = micros();
+   if ((long)(micros() - Proximo) >= 0) {
+      Proximo += PERIODO;
+      analogWrite(PIN_ACTUADOR, PID.Controlar(REFERENCIA - analogRead(PIN_SENSOR)));
+   }
+
+   while (Serial.available()) {
+      if (Protocolo.Recibir(Serial.read())) {
+         Serial.write(Trama, Protocolo.ArmarAcuse(Trama));
+      }
+   }
+
+   // Una trama de datos con los registros que entren en el búfer de transmisión
+   // (en AVR es de 64 bytes: hasta 2 registros por trama):
+   uint8_t Entran = REGISTROS_TRAMA_PID;
+   int Lugar = Serial.availableForWrite();
+   while (Entran > 0 && (int)LARGO_TRAMA_PID(Entran * sizeof(muestraPID)) > Lugar) Entran--;
+   if (Entran > 0 && Telemetria.Disponibles() > 0) {
+      muestraPID Registros[REGISTROS_TRAMA_PID];
+      uint8_t Cantidad = Telemetria.Leer(Registros, Entran);
+      Serial.write(Trama, protocoloPID::ArmarDatos(Registros, Cantidad, Trama));
+   }
+}
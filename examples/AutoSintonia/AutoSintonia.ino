@@ -0,0 +1,49 @@
+/****************************************************************************************
+  AutoSintonia.ino
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Sintoniza un lazo de temperatura por el método del relé y sigue
+           controlando con el PID obtenido. La sintonía no bloquea: loop() sigue
+           corriendo y cada período se ejecuta una sola muestra.
+           El relé oscila entre 0 y 255 (CENTRO 127.5, AMPLITUD 127.5); la
+           histéresis de 1 unidad del ADC ignora el ruido de la medición.
+****************************************************************************************/
+
+#include <ControlPID.h>
+#include <ControlPIDAutoSintonia.h>
+
+const int PIN_SENSOR = A0;
+const int PIN_ACTUADOR = 9;
+const float REFERENCIA = 512;
+
+controlPID PID(1.0, 0.0, 0.0);
+autoSintoniaPID Sintonia(&PID);
+
+void setup()
+{  Serial.begin(115200);
+   PID.ConfigurarPeriodo(100000);    // 100 ms
+   PID.LimitarSalida(true, 0, 255);
+   PID.CondicionarIntegral(true);
+   Sintonia.LimitarDuracion(600000000UL);                  // 10 minutos por ciclo como máximo
+   Sintonia.Iniciar(127.5, 127.5, 1.0, ReglaSintonia::TyreusLuyben);
+}
+
+void loop()
+{  static unsigned long Proximo = micros();
+   if ((long)(micros() - Proximo) < 0) return;
+   Proximo += PID.ObtenerPeriodo();
+
+   EstadoSintonia Antes = Sintonia.ObtenerEstado();
+   analogWrite(PIN_ACTUADOR, Sintonia.Controlar(REFERENCIA - analogRead(PIN_SENSOR), Proximo));
+   if (Antes == EstadoSintonia::EnCurso && Sintonia.ObtenerEstado() != Antes) {
+      if (Sintonia.ObtenerEstado() == EstadoSintonia::Terminada) {
+         Serial.print("Ku = ");
+         Serial.print(Sintonia.ObtenerGananciaCritica());
+         Serial.print("  Pu = ");
+         Serial.print(Sintonia.ObtenerPeriodoCritico());
+         Serial.println(" s");
+      } else {
+         Serial.println("La planta no oscila: se sigue con el PID inicial");
+      }
+   }
+}
@@ -0,0 +1,54 @@
+/****************************************************************************************
+  ComparacionDSP.ino
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Compara el tiempo de Controlar() de controlPID (período fijo) contra
+           controlPIDDSP, que en Cortex-M4F/M7 con CMSIS-DSP usa arm_pid_f32 y en
+           los demás núcleos su versión portable.
+           Imprime ciclos de reloj promedio por llamada.
+           Los PID se ejecutan "en vacío" (sin planta): sólo interesa el costo.
+           Las salidas no son idénticas: controlPIDDSP integra por Euler hacia
+           atrás y controlPID por Tustin (ver ControlPIDDSP.h).
+****************************************************************************************/
+
+#include <ControlPID.h>
+#include <ControlPIDDSP.h>
+
+const unsigned long PERIODO = 1000;  // Período de muestreo (us)
+const int REPETICIONES = 1000;
+
+controlPID PID(2.0, 1.0, 0.05);
+controlPIDDSP PID_DSP(2.0, 1.0, 0.05, PERIODO);
+
+volatile float Salida;               // volatile: evita que el compilador elimine el cálculo
+
+void setup()
+{  Serial.begin(115200);
+   PID.ConfigurarPeriodo(PERIODO);
+   PID.LimitarSalida(true, -100, 100);
+   PID.CondicionarIntegral(true);
+   PID_DSP.LimitarSalida(true, -100, 100);
+   PID_DSP.CondicionarIntegral(true);
+}
+
+void loop()
+{  unsigned long Inicio, Duracion;
+   const float CICLOS_POR_US = F_CPU / 1e6;
+
+   Inicio = micros();
+   for (int i=0; i<REPETICIONES; i++) Salida = PID.Controlar((i & 63) * 0.1 - 3.2);
+   Duracion = micros() - Inicio;
+   Serial.print("controlPID:    ");
+   Serial.print(Duracion * CICLOS_POR_US / REPETICIONES);
+   Serial.println(" ciclos/llamada");
+
+   Inicio = micros();
+   for (int i=0; i<REPETICIONES; i++) Salida = PID_DSP.Controlar((i & 63) * 0.1 - 3.2);
+   Duracion = micros() - Inicio;
+   Serial.print(controlPIDDSP::Acelerado() ? "arm_pid_f32:   " : "portable:      ");
+   Serial.print(Duracion * CICLOS_POR_US / REPETICIONES);
+   Serial.println(" ciclos/llamada");
+
+   Serial.println();
+   delay(2000);
+}
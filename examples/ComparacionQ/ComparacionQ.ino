@@ -0,0 +1,62 @@
+/****************************************************************************************
+  ComparacionQ.ino
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Compara el tiempo de Controlar() de controlPID (float) contra
+           controlPID_Q16_16 y controlPID_Q15 (punto fijo).
+           Imprime ciclos de reloj promedio por llamada.
+           Los PID se ejecutan "en vacío" (sin planta): sólo interesa el costo.
+****************************************************************************************/
+
+#include <ControlPID.h>
+#include <ControlPID_Q.h>
+
+const unsigned long PERIODO = 1000;  // Período de muestreo para las versiones en Q (us)
+const int REPETICIONES = 1000;
+
+controlPID PID(2.0, 1.0, 0.05);
+controlPID_Q16_16 PID_Q16(2.0, 1.0, 0.05, PERIODO);
+controlPID_Q15 PID_Q15(0.5, 1.0, 0.0005, PERIODO);   // En Q15 los coeficientes deben ser <1
+
+volatile float SalidaF;              // volatile: evita que el compilador elimine el cálculo
+volatile int32_t SalidaQ16;
+volatile int16_t SalidaQ15;
+
+void setup()
+{  Serial.begin(115200);
+   PID.LimitarSalida(true, -100, 100);
+   PID.CondicionarIntegral(true);
+   PID_Q16.LimitarSalida(true, PID_Q16.AFijo(-100), PID_Q16.AFijo(100));
+   PID_Q16.CondicionarIntegral(true);
+   PID_Q15.LimitarSalida(true, PID_Q15.AFijo(-0.9), PID_Q15.AFijo(0.9));
+   PID_Q15.CondicionarIntegral(true);
+}
+
+void loop()
+{  unsigned long Inicio, Duracion;
+   const float CICLOS_POR_US = F_CPU / 1e6;
+
+   Inicio = micros();
+   for (int i=0; i<REPETICIONES; i++) SalidaF = PID.Controlar((i & 63) * 0.1 - 3.2);
+   Duracion = micros() - Inicio;
+   Serial.print("float:    ");
+   Serial.print(Duracion * CICLOS_POR_US / REPETICIONES);
+   Serial.println(" ciclos/llamada");
+
+   Inicio = micros();
+   for (int i=0; i<REPETICIONES; i++) SalidaQ16 = PID_Q16.Controlar(((int32_t)(i & 63) - 32) * 6554);
+   Duracion = micros() - Inicio;
+   Serial.print("Q16.16:   ");
+   Serial.print(Duracion * CICLOS_POR_US / REPETICIONES);
+   Serial.println(" ciclos/llamada");
+
+   Inicio = micros();
+   for (int i=0; i<REPETICIONES; i++) SalidaQ15 = PID_Q15.Controlar(((int16_t)(i & 63) - 32) * 512);
+   Duracion = micros() - Inicio;
+   Serial.print("Q15:      ");
+   Serial.print(Duracion * CICLOS_POR_US / REPETICIONES);
+   Serial.println(" ciclos/llamada");
+
+   Serial.println();
+   delay(2000);
+}
@@ -0,0 +1,48 @@
+/****************************************************************************************
+  Eventos.ino
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Lazo térmico lento en modo por eventos: el PID sólo calcula cuando la
+           temperatura cambia más de UMBRAL_ERROR o pasan INTERVALO_MAXIMO
+           microsegundos, y el actuador sólo se escribe cuando ControlarPorEvento()
+           devuelve true (la salida cambió más de UMBRAL_SALIDA). Con un sensor
+           cuantizado y una planta lenta se ahorra la mayor parte de los cálculos
+           y de las escrituras sin cambiar la respuesta del lazo.
+****************************************************************************************/
+
+#include <ControlPID.h>
+
+const int PIN_SENSOR = A0;
+const int PIN_ACTUADOR = 9;
+const float REFERENCIA = 512;
+const float UMBRAL_ERROR = 2;                  // Cuentas del ADC
+const unsigned long INTERVALO_MAXIMO = 5000000; // 5 s
+const float UMBRAL_SALIDA = 1;                 // Un paso de PWM
+
+controlPID PID(4.0, 120.0, 0.0);
+unsigned long Escrituras = 0;
+
+void setup()
+{  Serial.begin(115200);
+   PID.LimitarSalida(true, 0, 255);
+   PID.CondicionarIntegral(true);
+   PID.ConfigurarEventos(UMBRAL_ERROR, INTERVALO_MAXIMO, UMBRAL_SALIDA);
+}
+
+void loop()
+{  // Sin período fijo: ControlarPorEvento() mide el tiempo con micros().
+   float Error = REFERENCIA - analogRead(PIN_SENSOR);
+   if (PID.ControlarPorEvento(Error)) {
+      analogWrite(PIN_ACTUADOR, (int)PID.ObtenerSalida());
+      Escrituras++;
+   }
+
+   static unsigned long Informe = millis();
+   if (millis() - Informe >= 10000) {
+      Informe += 10000;
+      Serial.print("Escrituras en 10 s: ");
+      Serial.println(Escrituras);
+      Escrituras = 0;
+   }
+   delay(10);
+}
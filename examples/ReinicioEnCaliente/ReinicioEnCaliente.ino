@@ -0,0 +1,61 @@
+/****************************************************************************************
+  ReinicioEnCaliente.ino
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Guarda periódicamente el estado del PID en EEPROM y lo restaura al arrancar,
+           de modo que tras un reinicio (caída de tensión) el lazo retoma su punto de
+           operación en lugar de partir de integral nula.
+           guardadoPID limita las escrituras para no gastar la EEPROM.
+           En ESP32 la EEPROM se emula en flash: hace falta EEPROM.begin() y
+           EEPROM.commit().
+****************************************************************************************/
+
+#include <EEPROM.h>
+#include <ControlPID.h>
+#include <ControlPIDEstado.h>
+
+const int DIRECCION = 0;             // Dirección del estado en la EEPROM
+const int PIN_SENSOR = A0;
+const int PIN_ACTUADOR = 9;
+const float REFERENCIA = 512;
+
+controlPID PID(0.5, 20.0, 0.0);
+guardadoPID Guardado(60000, 2.0);    // A lo sumo una escritura por minuto
+estadoPID Estado;
+
+void setup()
+{  Serial.begin(115200);
+#if defined(ESP32)
+   EEPROM.begin(sizeof(estadoPID));
+#endif
+   EEPROM.get(DIRECCION, Estado);
+   if (PID.RestaurarEstado(Estado)) {
+      Serial.println("Estado restaurado");
+      Guardado.Inicializar(Estado);
+   } else {
+      // Primera vez (o EEPROM con otro contenido): configuración inicial.
+      Serial.println("Sin estado guardado");
+      PID.ConfigurarPeriodo(10000);
+      PID.LimitarSalida(true, 0, 255);
+      PID.CondicionarIntegral(true);
+   }
+}
+
+void loop()
+{  static unsigned long Proximo = micros();
+   if ((long)(micros() - Proximo) < 0) return;
+   Proximo += PID.ObtenerPeriodo();
+
+   analogWrite(PIN_ACTUADOR, PID.Controlar(REFERENCIA - analogRead(PIN_SENSOR)));
+
+   static unsigned long UltimaRevision = 0;
+   if (millis() - UltimaRevision < 1000) return;            // El CRC cuesta: reviso cada segundo
+   UltimaRevision = millis();
+   PID.GuardarEstado(Estado);
+   if (Guardado.Revisar(Estado, millis())) {
+      EEPROM.put(DIRECCION, Estado);   // En AVR sólo reescribe los bytes que cambiaron
+#if defined(ESP32)
+      EEPROM.commit();
+#endif
+   }
+}
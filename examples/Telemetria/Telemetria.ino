@@ -0,0 +1,47 @@
+/****************************************************************************************
+  Telemetria.ino
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Registra cada muestra del PID en una cola de telemetría y la envía en binario
+           por Serial (28 bytes por registro, ver muestraPID) sólo cuando hay lugar en
+           el búfer de transmisión: el envío nunca demora al lazo.
+           El PID corre a 1 kHz; en una aplicación real Controlar() iría en la
+           interrupción del timer y el envío quedaría igual en loop().
+****************************************************************************************/
+
+#include <ControlPID.h>
+#include <ControlPIDTelemetria.h>
+
+const unsigned long PERIODO = 1000;  // Período de muestreo (us)
+const int PIN_SENSOR = A0;
+const int PIN_ACTUADOR = 9;
+const float REFERENCIA = 512;
+
+controlPID PID(0.5, 2.0, 0.01);
+telemetriaPID<32> Telemetria;
+
+void setup()
+{  Serial.begin(500000);
+   PID.ConfigurarPeriodo(PERIODO);
+   PID.LimitarSalida(true, 0, 255);
+   PID.CondicionarIntegral(true);
+   PID.ConectarTelemetria(&Telemetria);
+}
+
+void loop()
+{  static unsigned long Proximo = micros();
+   if ((long)(micros() - Proximo) >= 0) {
+      Proximo += PERIODO;
+      analogWrite(PIN_ACTUADOR, PID.Controlar(REFERENCIA - analogRead(PIN_SENSOR)));
+   }
+
+   // Envío sólo los registros enteros que entran sin bloquear:
+   indiceColaPID Cantidad;
+   const muestraPID* Bloque = Telemetria.Bloque(Cantidad);
+   int Entran = Serial.availableForWrite() / sizeof(muestraPID);
+   if ((int)Cantidad > Entran) Cantidad = Entran;
+   if (Cantidad > 0) {
+      Serial.write((const uint8_t*)Bloque, Cantidad * sizeof(muestraPID));
+      Telemetria.Liberar(Cantidad);
+   }
+}
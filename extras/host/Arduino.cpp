@@ -0,0 +1,18 @@
+/****************************************************************************************
+  Arduino.cpp (PC)
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Reloj simulado para el reemplazo de Arduino.h en la PC.
+****************************************************************************************/
+
+#include "Arduino.h"
+
+uint32_t MicrosSimulado = 0;
+
+unsigned long micros()
+{  return MicrosSimulado;
+}
+
+unsigned long millis()
+{  return MicrosSimulado / 1000;
+}
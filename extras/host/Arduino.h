@@ -0,0 +1,45 @@
+/****************************************************************************************
+  Arduino.h (PC)
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Reemplazo mínimo de Arduino.h para compilar la biblioteca en la PC
+           (simulación, pruebas de deriva y mediciones de rendimiento).
+           micros() devuelve un reloj simulado de 32 bits que maneja el programa,
+           de modo que desborda igual que en el microcontrolador.
+-----------------------------------------------------------------------------------------
+  Autor:   Colaboradores de ControlPID, sobre la biblioteca original de
+           Guillermo Caporaletti <gfcaporaletti@undav.edu.ar>
+           Sistemas de Control Automático (SCA)
+           Universidad Nacional de Avellaneda (UNDAV)
+  Fecha:   Octubre 2026
+  Version: 1.1
+****************************************************************************************/
+
+#ifndef ARDUINO_PC_h
+#define ARDUINO_PC_h
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+extern uint32_t MicrosSimulado;      // Reloj simulado en microsegundos (lo avanza el programa)
+unsigned long micros();              // Devuelve MicrosSimulado
+unsigned long millis();              // Devuelve MicrosSimulado/1000
+
+// Sin interrupciones en la PC:
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+// Memoria de programa: en la PC es memoria común.
+#define PROGMEM
+#define memcpy_P(DESTINO, ORIGEN, BYTES) memcpy((DESTINO), (ORIGEN), (BYTES))
+#define pgm_read_float(DIRECCION) (*(const float*)(DIRECCION))
+
+// Como en los núcleos de 32 bits (ESP32, ARM) min y max exigen el mismo tipo
+// en ambos argumentos: así la PC detecta los mismos errores que esas plataformas.
+template <typename T> inline const T& min(const T& A, const T& B) { return (B < A) ? B : A; }
+template <typename T> inline const T& max(const T& A, const T& B) { return (A < B) ? B : A; }
+
+#endif
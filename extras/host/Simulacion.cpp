@@ -0,0 +1,124 @@
+/****************************************************************************************
+  Simulacion.cpp (PC)
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Plantas simuladas, ensayo de lazo cerrado y barrido en paralelo.
+****************************************************************************************/
+
+#include "Simulacion.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+/***************************************************************************************/
+
+plantaSimulada::plantaSimulada(const modeloPlanta& MODELO, double PERIODO)
+{  Modelo = MODELO;
+   Periodo = PERIODO;
+   Coef = (Modelo.Tipo == TipoPlanta::PrimerOrden && Modelo.A > 0) ? exp(-Periodo / Modelo.A) : 0;
+   size_t Muestras = (size_t)(Modelo.Retardo / Periodo + 0.5);
+   Demora.assign(Muestras, 0.0f);
+   Reiniciar();
+}
+//-------------------------------------------------------------------------------------
+
+void plantaSimulada::Reiniciar()
+{  Y = 0;
+   V = 0;
+   Posicion = 0;
+   for (float& U : Demora) U = 0;
+}
+//-------------------------------------------------------------------------------------
+
+double plantaSimulada::Avanzar(float ENTRADA)
+{  float U = ENTRADA;
+   if (!Demora.empty()) {
+      U = Demora[Posicion];
+      Demora[Posicion] = ENTRADA;
+      if (++Posicion == Demora.size()) Posicion = 0;
+   }
+   switch (Modelo.Tipo) {
+      case TipoPlanta::PrimerOrden:
+         // Discretización exacta con retención de orden cero.
+         Y = Coef * Y + Modelo.K * (1 - Coef) * U;
+         break;
+      case TipoPlanta::SegundoOrden: {
+         // Runge-Kutta de 4º orden con 8 subpasos (U constante en el período).
+         const double H = Periodo / 8, Wn = Modelo.A, Z = Modelo.B;
+         const double F = Modelo.K * Wn * Wn * U;
+         for (int i = 0; i < 8; i++) {
+            double a1 = V,            b1 = F - 2*Z*Wn*V - Wn*Wn*Y;
+            double a2 = V + H/2*b1,   b2 = F - 2*Z*Wn*a2 - Wn*Wn*(Y + H/2*a1);
+            double a3 = V + H/2*b2,   b3 = F - 2*Z*Wn*a3 - Wn*Wn*(Y + H/2*a2);
+            double a4 = V + H*b3,     b4 = F - 2*Z*Wn*a4 - Wn*Wn*(Y + H*a3);
+            Y += H/6 * (a1 + 2*a2 + 2*a3 + a4);
+            V += H/6 * (b1 + 2*b2 + 2*b3 + b4);
+         }
+         break;
+      }
+      case TipoPlanta::Integradora:
+         Y += Modelo.K * U * Periodo;
+         break;
+   }
+   return Y;
+}
+//-------------------------------------------------------------------------------------
+
+resultadoPID Simular(const ensayoPID& ENSAYO)
+{  controlPID PID(ENSAYO.Kp, ENSAYO.Ti, ENSAYO.Td);
+   PID.LimitarSalida(true, ENSAYO.SalidaMin, ENSAYO.SalidaMax);
+   PID.FiltrarDerivativo(ENSAYO.FiltroDerivativo);
+   PID.LimitarIntegral(ENSAYO.AntiEnrole == AntiEnroleSimulado::LimiteIntegral);
+   PID.CondicionarIntegral(ENSAYO.AntiEnrole == AntiEnroleSimulado::Condicional);
+   PID.RetrocalcularIntegral(ENSAYO.AntiEnrole == AntiEnroleSimulado::Retrocalculo, ENSAYO.TiempoSeguimiento);
+
+   const double Ts = ENSAYO.Periodo / 1e6;
+   plantaSimulada Planta(ENSAYO.Planta, Ts);
+   const unsigned long Pasos = (unsigned long)(ENSAYO.Duracion / Ts);
+   const double Banda = 0.02 * fabs(ENSAYO.Referencia);
+   resultadoPID Resultado = {0, 0, 0, 0, 0, 0, Pasos};
+   double Maximo = 0;
+   uint32_t Reloj = 0;               // Reloj virtual de 32 bits (desborda como micros())
+
+   auto Inicio = std::chrono::steady_clock::now();
+   for (unsigned long k = 0; k < Pasos; k++) {
+      double t = k * Ts;
+      double Y = Planta.Salida();
+      double Error = ENSAYO.Referencia - Y;
+      float Salida = PID.Controlar((float)Error, (unsigned long)Reloj);
+      boolean Perturbada = ENSAYO.TiempoPerturbacion >= 0 && t >= ENSAYO.TiempoPerturbacion;
+      Planta.Avanzar(Perturbada ? Salida + ENSAYO.Perturbacion : Salida);
+      Reloj += ENSAYO.Periodo;
+
+      double Absoluto = fabs(Error);
+      Resultado.IAE += Absoluto * Ts;
+      Resultado.ISE += Error * Error * Ts;
+      Resultado.ITAE += t * Absoluto * Ts;
+      if (!Perturbada && (ENSAYO.Referencia >= 0 ? Y : -Y) > Maximo) Maximo = ENSAYO.Referencia >= 0 ? Y : -Y;
+      if (!Perturbada && Absoluto > Banda) Resultado.Establecimiento = t + Ts;
+   }
+   Resultado.NsPorPaso = Pasos ? std::chrono::duration<double, std::nano>(
+                            std::chrono::steady_clock::now() - Inicio).count() / Pasos : 0;
+   double R = fabs(ENSAYO.Referencia);
+   Resultado.Sobrepico = (R > 0 && Maximo > R) ? 100 * (Maximo - R) / R : 0;
+   return Resultado;
+}
+//-------------------------------------------------------------------------------------
+
+void SimularEnParalelo(const ensayoPID* ENSAYOS, resultadoPID* RESULTADOS, size_t CANTIDAD, unsigned HILOS)
+// Cada hilo toma el siguiente ensayo libre: el reparto se equilibra solo aunque los
+// ensayos duren distinto, y el resultado no depende de la cantidad de hilos.
+{  if (HILOS == 0) HILOS = std::thread::hardware_concurrency();
+   if (HILOS == 0) HILOS = 1;
+   std::atomic<size_t> Siguiente(0);
+   auto Trabajar = [&]() {
+      for (size_t i = Siguiente++; i < CANTIDAD; i = Siguiente++) {
+         RESULTADOS[i] = Simular(ENSAYOS[i]);
+      }
+   };
+   std::vector<std::thread> Hilos;
+   for (unsigned h = 1; h < HILOS; h++) Hilos.emplace_back(Trabajar);
+   Trabajar();
+   for (std::thread& Hilo : Hilos) Hilo.join();
+}
+//-------------------------------------------------------------------------------------
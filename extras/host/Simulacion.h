@@ -0,0 +1,84 @@
+/****************************************************************************************
+  Simulacion.h (PC)
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Simulación en la PC de un lazo cerrado controlPID + planta, con reloj virtual
+           (no usa MicrosSimulado: cada simulación tiene su propio reloj y se pueden
+           correr varias en paralelo, una por hilo).
+           Plantas (todas con retardo puro L, múltiplo del período de muestreo):
+              PrimerOrden   K e^(-Ls) / (tau s + 1)             A = tau
+              SegundoOrden  K wn^2 e^(-Ls) / (s^2 + 2 zeta wn s + wn^2)   A = wn, B = zeta
+              Integradora   K e^(-Ls) / s
+           La salida del PID se mantiene constante durante el período (retención de
+           orden cero). El ensayo es un escalón de referencia en t=0 y, opcionalmente,
+           un escalón de perturbación a la entrada de la planta.
+           Índices: IAE, ISE, ITAE, sobrepico (% de la referencia), tiempo de
+           establecimiento (banda del 2%; ambos del escalón de referencia) y ns por
+           paso de lazo cerrado (PID + planta).
+****************************************************************************************/
+
+#ifndef SIMULACION_PC_h
+#define SIMULACION_PC_h
+#include "Arduino.h"
+#include "ControlPID.h"
+#include <vector>
+
+/***************************************************************************************/
+
+enum class TipoPlanta : uint8_t { PrimerOrden, SegundoOrden, Integradora };
+enum class AntiEnroleSimulado : uint8_t { Ninguno, LimiteIntegral, Condicional, Retrocalculo };
+
+struct modeloPlanta                  // Parámetros de la planta (tiempos en segundos)
+{  TipoPlanta Tipo;
+   double K;                         // Ganancia
+   double A;                         // tau (PrimerOrden) o wn (SegundoOrden)
+   double B;                         // zeta (SegundoOrden)
+   double Retardo;                   // L
+};
+
+class plantaSimulada                 // Planta discretizada con período fijo
+{  private:
+      modeloPlanta Modelo;
+      double Periodo;                // En segundos
+      double Coef;                   // e^(-Ts/tau) (PrimerOrden)
+      double Y, V;                   // Salida y su derivada
+      std::vector<float> Demora;     // Entradas retenidas (retardo puro)
+      size_t Posicion;
+   public:
+      plantaSimulada(const modeloPlanta& MODELO, double PERIODO);
+      void Reiniciar();
+      double Avanzar(float ENTRADA); // Un período con ENTRADA constante; devuelve la salida.
+      double Salida() const { return Y; }
+};
+
+struct ensayoPID                     // Configuración de una simulación
+{  modeloPlanta Planta;
+   float Kp, Ti, Td;                 // Constantes del PID (Ti, Td en segundos)
+   float FiltroDerivativo;           // N (0: sin filtro)
+   AntiEnroleSimulado AntiEnrole;
+   float TiempoSeguimiento;          // Tt del retrocálculo (s)
+   float SalidaMin, SalidaMax;
+   float Referencia;                 // Escalón de referencia en t=0
+   float Perturbacion;               // Escalón a la entrada de la planta...
+   double TiempoPerturbacion;        // ...en este tiempo (s; negativo: sin perturbación)
+   double Duracion;                  // Tiempo simulado (s)
+   unsigned long Periodo;            // Período de muestreo (us)
+};
+
+struct resultadoPID                  // Índices de desempeño
+{  double IAE, ISE, ITAE;
+   double Sobrepico;                 // En % de la referencia (antes de la perturbación)
+   double Establecimiento;           // Último instante fuera de la banda del 2% (s, ídem)
+   double NsPorPaso;                 // Costo de un paso (PID + planta) en la PC
+   unsigned long Pasos;
+};
+
+resultadoPID Simular(const ensayoPID& ENSAYO);
+                                     // Corre un ensayo completo. Reentrante: sólo usa
+                                     // memoria propia (se puede llamar desde varios hilos).
+void SimularEnParalelo(const ensayoPID* ENSAYOS, resultadoPID* RESULTADOS, size_t CANTIDAD, unsigned HILOS);
+                                     // Reparte los ensayos entre HILOS hilos (0: uno por núcleo).
+
+/***************************************************************************************/
+
+#endif
@@ -0,0 +1,98 @@
+/****************************************************************************************
+  cascada.cpp
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Verifica que la saturación del lazo más interno de una cascadaPID llegue a
+           todos los externos. Cascada posición -> velocidad -> corriente de un motor
+           (L/R = 1 ms, sin rozamiento, tensión de ±20) con CondicionarIntegral en los tres lazos.
+           Ante un escalón grande de posición sólo la tensión (salida del lazo de
+           corriente) se satura: los lazos de velocidad y de posición no llegan a
+           sus propios límites. Si la saturación no se propagara, la integral del
+           lazo de posición crecería durante toda la aceleración y el motor se
+           pasaría de la referencia.
+           Sin propagar la saturación el sobrepico es de 18%; propagándola queda el
+           de la integral de posición fuera de la saturación (unos 6%).
+           Termina con código 1 si el sobrepico supera el 10%, la integral del lazo de
+           posición crece mientras el lazo de corriente está saturado o la posición
+           no llega a la referencia.
+-----------------------------------------------------------------------------------------
+  Uso:
+           ./cascada
+****************************************************************************************/
+
+#include "Arduino.h"
+#include "ControlPID.h"
+#include "ControlPIDCascada.h"
+#include <stdio.h>
+
+/***************************************************************************************/
+
+static const unsigned long PERIODO = 100;  // Período del lazo de corriente (us)
+static const double TS = PERIODO / 1e6;
+static const float REFERENCIA = 10;        // Escalón de posición
+
+static double Corriente = 0, Velocidad = 0, Posicion = 0;
+static float Tension = 0;
+
+static float LeerCorriente() { return Corriente; }
+static float LeerVelocidad() { return Velocidad; }
+static float LeerPosicion()  { return Posicion; }
+static void EscribirTension(float TENSION) { Tension = TENSION; }
+
+static void AvanzarMotor()
+// Un período con la tensión constante: di/dt = (u - i)/0.001, dw/dt = 10 i, dx/dt = w.
+{  const int PASOS = 10;
+   const double DT = TS / PASOS;
+   for (int k = 0; k < PASOS; k++) {
+      Corriente += DT * (Tension - Corriente) / 0.001;
+      Velocidad += DT * 10 * Corriente;
+      Posicion += DT * Velocidad;
+   }
+}
+
+/***************************************************************************************/
+
+int main()
+{  controlPID PIDPosicion(5.0, 1.0, 0);
+   controlPID PIDVelocidad(20.0, 0.05, 0);
+   controlPID PIDCorriente(2.0, 0.001, 0);
+   PIDPosicion.LimitarSalida(true, -100, 100);       // Holgados: sólo satura la tensión
+   PIDVelocidad.LimitarSalida(true, -10000, 10000);
+   PIDCorriente.LimitarSalida(true, -20, 20);
+   PIDPosicion.CondicionarIntegral(true);
+   PIDVelocidad.CondicionarIntegral(true);
+   PIDCorriente.CondicionarIntegral(true);
+   cascadaPID<3> Cascada(EscribirTension);
+   Cascada.Agregar(&PIDPosicion, LeerPosicion, 1);
+   Cascada.Agregar(&PIDVelocidad, LeerVelocidad, 5);
+   Cascada.Agregar(&PIDCorriente, LeerCorriente, 4);
+   Cascada.FijarReferencia(REFERENCIA);
+
+   const int MUESTRAS = 5000000 / PERIODO;           // 5 segundos
+   unsigned long Ahora = 1000;
+   double Maximo = 0, Crecimiento = 0;
+   float IntegralAnterior = 0;
+   int Saturadas = 0, Seguidas = 0;
+   for (int n = 0; n < MUESTRAS; n++) {
+      uint8_t Corrieron = Cascada.Ejecutar(Ahora);
+      // Tras 24 muestras seguidas con la tensión saturada la saturación ya recorrió
+      // la cascada (velocidad corre cada 4 y posición cada 20): desde entonces la
+      // integral de posición no debe cambiar en las ejecuciones de ese lazo.
+      if (Corrieron == 3) {
+         float Integral = PIDPosicion.ObtenerIntegral();
+         if (Seguidas >= 20 + 4) Crecimiento += fabs(Integral - IntegralAnterior);
+         IntegralAnterior = Integral;
+      }
+      if (PIDCorriente.EstaSaturada()) { Saturadas++; Seguidas++; }
+      else Seguidas = 0;
+      AvanzarMotor();
+      Ahora += PERIODO;
+      if (Posicion > Maximo) Maximo = Posicion;
+   }
+   double Sobrepico = 100 * (Maximo - REFERENCIA) / REFERENCIA;
+   boolean Correcto = Sobrepico <= 10 && Crecimiento == 0 && fabs(Posicion - REFERENCIA) < 0.01;
+   printf("muestras con la tensión saturada: %d de %d\n", Saturadas, MUESTRAS);
+   printf("integral de posición en saturación: %g  final: %g\n", Crecimiento, PIDPosicion.ObtenerIntegral());
+   printf("posición final: %.4f  sobrepico: %.2f%%  %s\n", Posicion, Sobrepico, Correcto ? "ok" : "FALLA");
+   return Correcto ? 0 : 1;
+}
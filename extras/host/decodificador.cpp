@@ -0,0 +1,142 @@
+/****************************************************************************************
+  decodificador.cpp
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Decodificador en la PC del protocolo binario de ControlPIDProtocolo.h.
+           Lee tramas de un archivo o de la entrada estándar (un puerto serie ya
+           configurado) e imprime los registros de telemetría como CSV. Los acuses
+           y el resumen (tramas inválidas, registros perdidos) van a stderr.
+           También arma las tramas de órdenes y las escribe en la salida estándar,
+           para redirigirlas al puerto.
+-----------------------------------------------------------------------------------------
+  Uso:
+           stty -F /dev/ttyACM0 raw 2000000
+           ./decodificador /dev/ttyACM0 > registro.csv
+           ./decodificador --crudo /dev/ttyACM0 > traza.bin   (registros muestraPID
+                                                              binarios, para ./reproductor)
+           ./decodificador --pid LAZO KP TI TD > /dev/ttyACM0
+           ./decodificador --salida LAZO ACTIVA MIN MAX > /dev/ttyACM0
+           ./decodificador --integral LAZO ACTIVA > /dev/ttyACM0
+           ./decodificador --condicional LAZO ACTIVA > /dev/ttyACM0
+****************************************************************************************/
+
+#include "Arduino.h"
+#include "ControlPIDProtocolo.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/***************************************************************************************/
+
+static int Orden(int argc, char** argv)
+// Arma la trama de la orden pedida y la escribe en stdout.
+{  uint8_t Datos[12];
+   size_t Largo = 0;
+   TramaPID Tipo;
+   float Valores[3];
+   const char* Nombre = argv[1];
+   if (argc < 3) return 1;
+   uint8_t Lazo = (uint8_t)atoi(argv[2]);
+   if (strcmp(Nombre, "--pid") == 0 && argc == 6) {
+      Tipo = TramaPID::ConfigurarPID;
+      for (int i = 0; i < 3; i++) Valores[i] = (float)atof(argv[3 + i]);
+      memcpy(Datos, Valores, 12);
+      Largo = 12;
+   } else if (strcmp(Nombre, "--salida") == 0 && argc == 6) {
+      Tipo = TramaPID::LimitarSalida;
+      Datos[0] = (uint8_t)atoi(argv[3]);
+      Valores[0] = (float)atof(argv[4]);
+      Valores[1] = (float)atof(argv[5]);
+      memcpy(Datos + 1, Valores, 8);
+      Largo = 9;
+   } else if (strcmp(Nombre, "--integral") == 0 && argc == 4) {
+      Tipo = TramaPID::LimitarIntegral;
+      Datos[0] = (uint8_t)atoi(argv[3]);
+      Largo = 1;
+   } else if (strcmp(Nombre, "--condicional") == 0 && argc == 4) {
+      Tipo = TramaPID::CondicionarIntegral;
+      Datos[0] = (uint8_t)atoi(argv[3]);
+      Largo = 1;
+   } else {
+      return 1;
+   }
+   uint8_t Trama[LARGO_TRAMA_PID(12)];
+   size_t Bytes = ArmarTramaPID(Tipo, Lazo, Datos, Largo, Trama);
+   fwrite(Trama, 1, Bytes, stdout);
+   return 0;
+}
+
+/***************************************************************************************/
+
+int main(int argc, char** argv)
+{  bool Crudo = argc >= 2 && strcmp(argv[1], "--crudo") == 0;
+   if (Crudo) {
+      argv++;
+      argc--;
+   }
+   if (argc >= 2 && strncmp(argv[1], "--", 2) == 0) {
+      int Resultado = Orden(argc, argv);
+      if (Resultado) fprintf(stderr, "orden inválida (ver el encabezado de decodificador.cpp)\n");
+      return Resultado;
+   }
+   FILE* Entrada = stdin;
+   if (argc >= 2) {
+      Entrada = fopen(argv[1], "rb");
+      if (!Entrada) {
+         perror(argv[1]);
+         return 1;
+      }
+   }
+
+   static uint8_t Codificada[4096];
+   static uint8_t Trama[4096];
+   size_t Largo = 0;
+   unsigned long Tramas = 0, Invalidas = 0, Registros = 0, Perdidos = 0;
+   bool HaySecuencia = false;
+   uint16_t Esperada = 0;
+   int Byte;
+   if (!Crudo) printf("lazo,secuencia,tiempo_us,error,proporcional,integral,derivativo,salida,saturada,integral_bloqueada\n");
+   while ((Byte = fgetc(Entrada)) != EOF) {
+      if (Byte != 0) {
+         if (Largo < sizeof(Codificada)) Codificada[Largo++] = (uint8_t)Byte;
+         continue;
+      }
+      size_t LargoTrama = (Largo > 0 && Largo < sizeof(Codificada)) ? AbrirTramaPID(Codificada, Largo, Trama) : 0;
+      bool Vacia = (Largo == 0);
+      Largo = 0;
+      if (Vacia) continue;
+      if (LargoTrama == 0) {
+         Invalidas++;
+         continue;
+      }
+      Tramas++;
+      TramaPID Tipo = (TramaPID)Trama[0];
+      size_t LargoDatos = LargoTrama - 2;
+      if (Tipo == TramaPID::Datos && LargoDatos % sizeof(muestraPID) == 0) {
+         for (size_t i = 0; i < LargoDatos / sizeof(muestraPID); i++) {
+            muestraPID M;
+            memcpy(&M, Trama + 2 + i * sizeof(muestraPID), sizeof(muestraPID));
+            if (HaySecuencia) Perdidos += (uint16_t)(M.Secuencia - Esperada);
+            HaySecuencia = true;
+            Esperada = M.Secuencia + 1;
+            Registros++;
+            if (Crudo) {
+               fwrite(&M, sizeof(M), 1, stdout);
+               continue;
+            }
+            printf("%u,%u,%lu,%.9g,%.9g,%.9g,%.9g,%.9g,%d,%d\n", M.Lazo, M.Secuencia, (unsigned long)M.Tiempo,
+                   M.Error, M.Proporcional, M.Integral, M.Derivativo, M.Salida,
+                   (M.Indicadores & muestraPID::SATURADA) != 0,
+                   (M.Indicadores & muestraPID::INTEGRAL_BLOQUEADA) != 0);
+         }
+      } else if (Tipo == TramaPID::Acuse && LargoDatos == 2) {
+         fprintf(stderr, "acuse: orden 0x%02x resultado %u\n", Trama[2], Trama[3]);
+      } else {
+         fprintf(stderr, "trama de tipo 0x%02x con %zu bytes de datos\n", Trama[0], LargoDatos);
+      }
+   }
+   fprintf(stderr, "%lu tramas, %lu inválidas, %lu registros, %lu perdidos\n",
+           Tramas, Invalidas, Registros, Perdidos);
+   if (Entrada != stdin) fclose(Entrada);
+   return 0;
+}
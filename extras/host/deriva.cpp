@@ -0,0 +1,141 @@
+/****************************************************************************************
+  deriva.cpp
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Simula días de funcionamiento de un lazo PID a 1 kHz en la PC para verificar
+           que el costo por llamada y el error numérico no crecen con el tiempo.
+           - El reloj simulado arranca cerca del desborde de micros() y desborda
+             cada ~71 minutos, como en el microcontrolador.
+           - Una vez por día simulado el programa se "bloquea" 3 segundos (demora).
+           - Un segundo lazo idéntico, con el PID calculado en double y un reloj de
+             64 bits, sirve de referencia: las diferencias entre ambos lazos son
+             sólo error numérico de float (y de micros() de 32 bits).
+           - Un tercer lazo usa DemoraPID::Apagar en lugar de Recortar: tras cada
+             demora debe volver a controlar (al final de cada hora la planta es
+             la misma que con Recortar).
+           Imprime una línea por hora simulada y termina con código 1 si la diferencia
+           crece a lo largo de la simulación (deriva) o hay demoras no detectadas.
+-----------------------------------------------------------------------------------------
+  Uso:
+           ./deriva [DIAS] [FRECUENCIA_HZ]      (por omisión: 3 días a 1000 Hz)
+****************************************************************************************/
+
+#include "Arduino.h"
+#include "ControlPID.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+/***************************************************************************************/
+
+struct referenciaPID                 // Mismo algoritmo que controlPID, en double
+{  double Kp, Ti, Td, SalidaMin, SalidaMax, IntervaloMaximo;
+   double Integral, ErrorAnterior;
+   bool PrimeraMuestra;
+
+   double Controlar(double ERROR, double INTERVALO)
+   {  if (!PrimeraMuestra && INTERVALO>IntervaloMaximo) INTERVALO = IntervaloMaximo;
+      bool HayMuestraAnterior = !PrimeraMuestra && INTERVALO>0;
+      double Derivativo = HayMuestraAnterior ? Kp*Td*(ERROR-ErrorAnterior)/INTERVALO : 0;
+      double Salida = Kp*ERROR + Integral + Derivativo;
+      bool Saturada = (Salida > SalidaMax) || (Salida < SalidaMin);
+      if (HayMuestraAnterior && !Saturada) Integral += Kp*(ERROR+ErrorAnterior)*INTERVALO/(2*Ti);
+      Salida = Kp*ERROR + Integral + Derivativo;
+      if (Salida > SalidaMax) Salida = SalidaMax;
+      if (Salida < SalidaMin) Salida = SalidaMin;
+      PrimeraMuestra = false;
+      ErrorAnterior = ERROR;
+      return Salida;
+   }
+};
+
+/***************************************************************************************/
+
+int main(int argc, char** argv)
+{  const double DIAS = (argc > 1) ? atof(argv[1]) : 3;
+   const double FRECUENCIA = (argc > 2) ? atof(argv[2]) : 1000;
+   const uint32_t PERIODO = (uint32_t)(1e6 / FRECUENCIA);
+   const uint64_t MUESTRAS_POR_HORA = (uint64_t)(3600 * FRECUENCIA);
+   const uint64_t MUESTRAS_POR_DIA = 24 * MUESTRAS_POR_HORA;
+   const uint64_t HORAS = (uint64_t)(DIAS * 24);
+   const uint32_t BLOQUEO = 3000000;            // Demora simulada una vez por día (us)
+
+   controlPID PID(2.0, 5.0, 0.05);
+   PID.LimitarSalida(true, -10, 10);
+   PID.CondicionarIntegral(true);
+   PID.LimitarIntervalo(5 * PERIODO, DemoraPID::Recortar);
+   controlPID PIDApagado(2.0, 5.0, 0.05);       // Ídem, apagándose ante una demora
+   PIDApagado.LimitarSalida(true, -10, 10);
+   PIDApagado.CondicionarIntegral(true);
+   PIDApagado.LimitarIntervalo(5 * PERIODO, DemoraPID::Apagar);
+   referenciaPID Referencia = { 2.0, 5.0, 0.05, -10, 10, 5e-6 * PERIODO, 0, 0, true };
+
+   MicrosSimulado = 0xFFFFFFFFUL - 60000000UL;  // Primer desborde al minuto
+   uint64_t Reloj = 0;                          // Reloj de referencia de 64 bits (us)
+   uint64_t RelojAnterior = 0;
+   double Planta = 0;                           // Planta de primer orden, tau = 2 s
+   double PlantaRef = 0;                        // Ídem, controlada por la referencia
+   double PlantaApagado = 0;                    // Ídem, controlada por PIDApagado
+   double MaxDifApagado = 0;                    // |Planta-PlantaApagado| al final de cada hora
+   double MaxDifSalidaInicial = 0, MaxDifSalida = 0, MaxDifIntegral = 0;
+   double NsMax = 0, NsMin = 1e30;
+   unsigned long DemorasEsperadas = 0;
+
+   printf("hora  ns/llamada  max|Δsalida|  max|Δintegral|  demoras\n");
+   for (uint64_t Hora = 0; Hora < HORAS; Hora++) {
+      double DifSalida = 0, DifIntegral = 0, Ns = 0;
+      for (uint64_t k = 0; k < MUESTRAS_POR_HORA; k++) {
+         uint64_t Muestra = Hora * MUESTRAS_POR_HORA + k;
+         if (Muestra % MUESTRAS_POR_DIA == MUESTRAS_POR_DIA / 2) {
+            MicrosSimulado += BLOQUEO;
+            Reloj += BLOQUEO;
+            DemorasEsperadas++;
+         }
+         double t = Reloj / 1e6;
+         double Referencia_r = ((Muestra / (600 * (uint64_t)FRECUENCIA)) % 2) ? 4.0 : 1.0;
+         double Perturbacion = 0.5 * sin(2 * M_PI * t / 37.0);
+         float Error = (float)(Referencia_r - Planta);
+         double ErrorRef = Referencia_r - PlantaRef;
+
+         auto Inicio = std::chrono::steady_clock::now();
+         float Salida = PID.Controlar(Error);
+         Ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - Inicio).count();
+
+         double SalidaRef = Referencia.Controlar(ErrorRef, Muestra ? (Reloj - RelojAnterior) / 1e6 : 0);
+         RelojAnterior = Reloj;
+         float SalidaApagado = PIDApagado.Controlar((float)(Referencia_r - PlantaApagado));
+         DifSalida = fmax(DifSalida, fabs(Salida - SalidaRef));
+         DifIntegral = fmax(DifIntegral, fabs(PID.ObtenerIntegral() - Referencia.Integral));
+
+         Planta += (Salida + Perturbacion - Planta) * (PERIODO / 1e6) / 2.0;
+         PlantaRef += (SalidaRef + Perturbacion - PlantaRef) * (PERIODO / 1e6) / 2.0;
+         PlantaApagado += (SalidaApagado + Perturbacion - PlantaApagado) * (PERIODO / 1e6) / 2.0;
+         if (k == MUESTRAS_POR_HORA - 1) MaxDifApagado = fmax(MaxDifApagado, fabs(Planta - PlantaApagado));
+         MicrosSimulado += PERIODO;
+         Reloj += PERIODO;
+      }
+      Ns /= MUESTRAS_POR_HORA;
+      NsMax = fmax(NsMax, Ns);
+      NsMin = fmin(NsMin, Ns);
+      if (Hora == 0) MaxDifSalidaInicial = DifSalida;
+      MaxDifSalida = fmax(MaxDifSalida, DifSalida);
+      MaxDifIntegral = fmax(MaxDifIntegral, DifIntegral);
+      printf("%4llu  %10.2f  %12.3e  %14.3e  %7lu\n", (unsigned long long)Hora, Ns,
+             DifSalida, DifIntegral, PID.ObtenerDemoras());
+   }
+
+   // Con el lazo cerrado el error numérico no se acumula: la diferencia máxima de
+   // cualquier hora debe ser del orden de la de la primera hora.
+   boolean DerivaAcotada = MaxDifSalida <= 2 * MaxDifSalidaInicial + 1e-5;
+   boolean DemorasCorrectas = PID.ObtenerDemoras() == DemorasEsperadas;
+   // Apagar: las mismas demoras y, al final de cada hora, la misma planta que con Recortar.
+   boolean ApagadoCorrecto = PIDApagado.ObtenerDemoras() == DemorasEsperadas && MaxDifApagado < 0.05;
+   printf("\nns/llamada (incluye la medición): min %.2f max %.2f\n", NsMin, NsMax);
+   printf("max|Δsalida| %.3e (primera hora %.3e), max|Δintegral| %.3e\n",
+          MaxDifSalida, MaxDifSalidaInicial, MaxDifIntegral);
+   printf("con Apagar: demoras %lu de %lu, max|Δplanta| al final de cada hora %.3e\n",
+          PIDApagado.ObtenerDemoras(), DemorasEsperadas, MaxDifApagado);
+   printf("deriva acotada: %s, demoras detectadas: %lu de %lu\n",
+          DerivaAcotada ? "sí" : "NO", PID.ObtenerDemoras(), DemorasEsperadas);
+   return (DerivaAcotada && DemorasCorrectas && ApagadoCorrecto) ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+/****************************************************************************************
+  discretizacion.cpp
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Verifica la componente derivativa de controlPID con cada DiscretizacionPID,
+           con período fijo y medido, ante un escalón del error (Kp=1, sin integral).
+           La respuesta de Kp*Td*s/(1+Tf*s) a un escalón es un pulso de área Kp*Td
+           que decae a 0: cada caso debe mantenerse acotado, decaer y conservar el área.
+           Incluye las combinaciones en que la aproximación pedida no es estable
+           (Tustin sin filtro, Euler hacia adelante con Ts >= 2*Tf, precompensación
+           con Ts >= pi*Tf), en que controlPID usa la más cercana estable.
+           Termina con código 1 si algún caso falla.
+-----------------------------------------------------------------------------------------
+  Uso:
+           ./discretizacion
+****************************************************************************************/
+
+#include "Arduino.h"
+#include "ControlPID.h"
+#include <stdio.h>
+
+/***************************************************************************************/
+
+struct casoDerivativo                // Constantes de un caso
+{  const char* Nombre;
+   float Td;                         // Tiempo derivativo (s)
+   float N;                          // Filtro Tf=Td/N (0: sin filtro)
+   unsigned long Periodo;            // Ts (us)
+};
+
+static const char* NombreMetodo(DiscretizacionPID METODO)
+{  switch (METODO) {
+      case DiscretizacionPID::Tustin:        return "Tustin";
+      case DiscretizacionPID::EulerAtras:    return "EulerAtras";
+      case DiscretizacionPID::EulerAdelante: return "EulerAdelante";
+      default:                               return "TustinPrecompensado";
+   }
+}
+
+static boolean Verificar(const casoDerivativo& CASO, DiscretizacionPID METODO, boolean PERIODO_FIJO)
+// Escalón del error en la segunda muestra. Derivativo = Salida - Kp*Error.
+{  const int MUESTRAS = 5000;
+   controlPID PID(1.0, 0.0, CASO.Td);
+   PID.FiltrarDerivativo(CASO.N);
+   PID.ConfigurarDiscretizacion(DiscretizacionPID::Tustin, METODO);
+   if (PERIODO_FIJO) PID.ConfigurarPeriodo(CASO.Periodo);
+   unsigned long Tiempo = 1000;
+   double Area = 0, Maximo = 0, Ultimo = 0;
+   boolean Acotado = true;
+   for (int n = 0; n < MUESTRAS; n++) {
+      float Error = (n > 0) ? 1.0f : 0.0f;
+      float Salida = PERIODO_FIJO ? PID.Controlar(Error) : PID.Controlar(Error, Tiempo);
+      Tiempo += CASO.Periodo;
+      double Derivativo = Salida - Error;
+      if (!(fabs(Derivativo) < 1e6)) Acotado = false;         // También descarta NAN
+      if (n > 1 && fabs(Derivativo) > Maximo * (1 + 1e-6)) Acotado = false;  // No crece tras el pulso
+      if (fabs(Derivativo) > Maximo) Maximo = fabs(Derivativo);
+      Area += Derivativo * CASO.Periodo / 1e6;
+      Ultimo = Derivativo;
+   }
+   boolean Decae = fabs(Ultimo) <= 1e-6 * Maximo;
+   boolean AreaCorrecta = fabs(Area - CASO.Td) <= 0.01 * CASO.Td;
+   boolean Correcto = Acotado && Decae && AreaCorrecta;
+   printf("%-24s %-20s %-6s  max %10.3e  final %10.3e  área/Td %8.5f  %s\n", CASO.Nombre,
+          NombreMetodo(METODO), PERIODO_FIJO ? "fijo" : "medido", Maximo, Ultimo,
+          Area / CASO.Td, Correcto ? "ok" : "FALLA");
+   return Correcto;
+}
+
+/***************************************************************************************/
+
+int main()
+{  const casoDerivativo CASOS[] = {
+      { "Td=0.1 N=10 Ts=1ms",    0.1f,  10,  1000 },   // Ts/Tf = 0.1: todas estables
+      { "Td=0.01 sin filtro",    0.01f, 0,   1000 },   // Tustin tendría un polo en z=-1
+      { "Td=0.01 N=100 Ts=1ms",  0.01f, 100, 1000 },   // Ts/Tf = 10: más allá de 2 y de pi
+   };
+   const DiscretizacionPID METODOS[] = { DiscretizacionPID::Tustin, DiscretizacionPID::EulerAtras,
+                                         DiscretizacionPID::EulerAdelante,
+                                         DiscretizacionPID::TustinPrecompensado };
+   int Fallas = 0;
+   for (const casoDerivativo& Caso : CASOS)
+      for (DiscretizacionPID Metodo : METODOS)
+         for (int Fijo = 1; Fijo >= 0; Fijo--)
+            if (!Verificar(Caso, Metodo, Fijo)) Fallas++;
+   printf("\ncasos con falla: %d\n", Fallas);
+   return Fallas ? 1 : 0;
+}
@@ -0,0 +1,246 @@
+/****************************************************************************************
+  rendimiento.cpp
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Mediciones de rendimiento de Controlar() en la PC (ns por llamada).
+           Cubre P, PI y PID, salida saturada y sin saturar, cada modo anti-enrole,
+           las variantes de tiempo (micros(), tiempo externo, período fijo) y las
+           demás clases de la biblioteca. Sirve como referencia común para comparar
+           optimizaciones: los números absolutos dependen de la PC, las proporciones
+           entre casos son las que interesan.
+
+           Cada caso repite el cálculo las veces necesarias para durar al menos
+           TIEMPO_MINIMO y se mide REPETICIONES veces; se informa la mediana.
+-----------------------------------------------------------------------------------------
+  Uso:
+           ./rendimiento [FILTRO] [--csv]
+           FILTRO: sólo corre los casos cuyo nombre contiene ese texto.
+           --csv:  imprime "caso,ns_por_llamada,iteraciones" (para guardar referencias).
+           rendimiento_doble es el mismo programa compilado con
+           CONTROLPID_ACUMULADOR=double (integral de controlPID en double).
+****************************************************************************************/
+
+#include "Arduino.h"
+#include "ControlPID.h"
+#include "ControlPID_Q.h"
+#include "ControlPIDT.h"
+#include "ControlPIDBank.h"
+#include "ControlPIDDSP.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+/***************************************************************************************/
+
+static const double TIEMPO_MINIMO = 0.05;      // Duración mínima de cada medición (s)
+static const int REPETICIONES = 5;             // Mediciones por caso (se toma la mediana)
+static const unsigned MUESTRAS = 1024;         // Largo de la secuencia de errores (potencia de 2)
+static float Errores[MUESTRAS];                // Errores pequeños (salida sin saturar)
+static float ErroresGrandes[MUESTRAS];         // Errores grandes (salida saturada)
+static volatile float Sumidero;                // Evita que el compilador descarte el cálculo
+
+typedef void (*FuncionCaso)(uint64_t ITERACIONES);
+
+struct casoRendimiento
+{  const char* Nombre;
+   FuncionCaso Funcion;
+};
+
+/***************************************************************************************/
+// Configuraciones de controlPID
+/***************************************************************************************/
+
+enum accionesPID { AccionP, AccionPI, AccionPID };
+enum antiEnrole { SinAntiEnrole, LimiteIntegral, Condicional, LimiteCondicional, Retrocalculo };
+
+static void Configurar(controlPID& PID, accionesPID ACCIONES, antiEnrole MODO)
+{  PID.ConfigurarPID(2.0, (ACCIONES==AccionP) ? 0 : 0.5, (ACCIONES==AccionPID) ? 0.05 : 0);
+   PID.LimitarSalida(true, -5, 5);
+   PID.LimitarIntegral(MODO==LimiteIntegral || MODO==LimiteCondicional);
+   PID.CondicionarIntegral(MODO==Condicional || MODO==LimiteCondicional);
+   PID.RetrocalcularIntegral(MODO==Retrocalculo, 0.2);
+}
+
+// Controlar(ERROR) con micros(): el reloj simulado avanza 1 ms por llamada.
+template <accionesPID ACCIONES, antiEnrole MODO, bool SATURADA>
+static void CasoMicros(uint64_t ITERACIONES)
+{  controlPID PID(0, 0, 0);
+   Configurar(PID, ACCIONES, MODO);
+   const float* E = SATURADA ? ErroresGrandes : Errores;
+   float Suma = 0;
+   for (uint64_t k = 0; k < ITERACIONES; k++) {
+      MicrosSimulado += 1000;
+      Suma += PID.Controlar(E[k & (MUESTRAS-1)]);
+   }
+   Sumidero = Suma;
+}
+
+template <accionesPID ACCIONES, antiEnrole MODO, bool SATURADA>
+static void CasoTiempo(uint64_t ITERACIONES)
+{  controlPID PID(0, 0, 0);
+   Configurar(PID, ACCIONES, MODO);
+   const float* E = SATURADA ? ErroresGrandes : Errores;
+   float Suma = 0;
+   for (uint64_t k = 0; k < ITERACIONES; k++) {
+      Suma += PID.Controlar(E[k & (MUESTRAS-1)], (unsigned long)(k * 1000));
+   }
+   Sumidero = Suma;
+}
+
+template <accionesPID ACCIONES, antiEnrole MODO, bool SATURADA>
+static void CasoPeriodoFijo(uint64_t ITERACIONES)
+{  controlPID PID(0, 0, 0);
+   Configurar(PID, ACCIONES, MODO);
+   PID.ConfigurarPeriodo(1000);
+   const float* E = SATURADA ? ErroresGrandes : Errores;
+   float Suma = 0;
+   for (uint64_t k = 0; k < ITERACIONES; k++) {
+      Suma += PID.Controlar(E[k & (MUESTRAS-1)]);
+   }
+   Sumidero = Suma;
+}
+
+// ControlarIncremental() (forma de velocidad) con período fijo.
+static void CasoIncremental(uint64_t ITERACIONES)
+{  controlPID PID(2.0, 0.5, 0.05);
+   PID.ConfigurarPeriodo(1000);
+   float Suma = 0;
+   for (uint64_t k = 0; k < ITERACIONES; k++) {
+      Suma += PID.ControlarIncremental(Errores[k & (MUESTRAS-1)]);
+   }
+   Sumidero = Suma;
+}
+
+/***************************************************************************************/
+// Otras clases
+/***************************************************************************************/
+
+template <typename Q>
+static void CasoQ(uint64_t ITERACIONES)
+{  Q PID(0.5, 0.5, 0.0005, 1000);
+   PID.LimitarSalida(true, Q::AFijo(-0.9), Q::AFijo(0.9));
+   PID.CondicionarIntegral(true);
+   float Suma = 0;
+   for (uint64_t k = 0; k < ITERACIONES; k++) {
+      Suma += PID.Controlar(Q::AFijo(Errores[k & (MUESTRAS-1)] * 0.1f));
+   }
+   Sumidero = Suma;
+}
+
+template <ModoPID MODO, SaturacionPID SATURACION, typename ESCALAR = float, typename ACUMULADOR = ESCALAR>
+static void CasoT(uint64_t ITERACIONES)
+{  controlPIDT<MODO, SATURACION, ESCALAR, ACUMULADOR> PID(2.0, 0.5, 0.05, 1000);
+   PID.LimitarSalida(-5, 5);
+   float Suma = 0;
+   for (uint64_t k = 0; k < ITERACIONES; k++) {
+      Suma += PID.Controlar(Errores[k & (MUESTRAS-1)]);
+   }
+   Sumidero = Suma;
+}
+
+// controlPIDDSP: en la PC es la versión portable de arm_pid_f32.
+static void CasoDSP(uint64_t ITERACIONES)
+{  controlPIDDSP PID(2.0, 0.5, 0.05, 1000);
+   PID.LimitarSalida(true, -5, 5);
+   PID.CondicionarIntegral(true);
+   float Suma = 0;
+   for (uint64_t k = 0; k < ITERACIONES; k++) {
+      Suma += PID.Controlar(Errores[k & (MUESTRAS-1)]);
+   }
+   Sumidero = Suma;
+}
+
+// Banco de 32 PID: se informa el tiempo por PID (no por llamada a ControlarTodos).
+static const uint8_t BANCO = 32;
+static void CasoBanco(uint64_t ITERACIONES)
+{  static controlPIDBank<BANCO> Banco;
+   float Entradas[BANCO], Salidas[BANCO];
+   for (uint8_t i = 0; i < BANCO; i++) {
+      Banco.ConfigurarPID(i, 2.0, 0.5, 0.05);
+      Banco.LimitarSalida(i, true, -5, 5);
+      Banco.CondicionarIntegral(i, true);
+   }
+   float Suma = 0;
+   for (uint64_t k = 0; k < ITERACIONES / BANCO + 1; k++) {
+      for (uint8_t i = 0; i < BANCO; i++) Entradas[i] = Errores[(k + i) & (MUESTRAS-1)];
+      Banco.ControlarTodos(Entradas, Salidas, (unsigned long)(k * 1000));
+      Suma += Salidas[0];
+   }
+   Sumidero = Suma;
+}
+
+/***************************************************************************************/
+
+#define CASOS_CONTROLPID(NOMBRE, FUNCION) \
+   { NOMBRE "/P/sin_saturar",                      FUNCION<AccionP,   SinAntiEnrole,     false> }, \
+   { NOMBRE "/PI/sin_saturar",                     FUNCION<AccionPI,  SinAntiEnrole,     false> }, \
+   { NOMBRE "/PID/sin_saturar",                    FUNCION<AccionPID, SinAntiEnrole,     false> }, \
+   { NOMBRE "/PID/saturada",                       FUNCION<AccionPID, SinAntiEnrole,     true>  }, \
+   { NOMBRE "/PID/limite_integral",                FUNCION<AccionPID, LimiteIntegral,    true>  }, \
+   { NOMBRE "/PID/condicional",                    FUNCION<AccionPID, Condicional,       true>  }, \
+   { NOMBRE "/PID/limite_condicional",             FUNCION<AccionPID, LimiteCondicional, true>  }, \
+   { NOMBRE "/PID/limite_condicional/sin_saturar", FUNCION<AccionPID, LimiteCondicional, false> }, \
+   { NOMBRE "/PID/retrocalculo",                   FUNCION<AccionPID, Retrocalculo,      true>  }
+
+static const casoRendimiento CASOS[] = {
+   CASOS_CONTROLPID("controlPID/micros", CasoMicros),
+   CASOS_CONTROLPID("controlPID/tiempo_externo", CasoTiempo),
+   CASOS_CONTROLPID("controlPID/periodo_fijo", CasoPeriodoFijo),
+   { "controlPID/periodo_fijo/PID/incremental",  CasoIncremental },
+   { "controlPIDT/PI/condicional",            CasoT<ModoPID::ProporcionalIntegral, SaturacionPID::Condicional> },
+   { "controlPIDT/PID/limite_condicional",    CasoT<ModoPID::Completo, SaturacionPID::IntegralCondicional> },
+   { "controlPIDT<float,double>/PID/limite_condicional",
+                                              CasoT<ModoPID::Completo, SaturacionPID::IntegralCondicional, float, double> },
+   { "controlPIDT<double>/PID/limite_condicional",
+                                              CasoT<ModoPID::Completo, SaturacionPID::IntegralCondicional, double> },
+   { "controlPIDDSP/PID/condicional",         CasoDSP },
+   { "controlPID_Q15/PID/condicional",        CasoQ<controlPID_Q15> },
+   { "controlPID_Q16_16/PID/condicional",     CasoQ<controlPID_Q16_16> },
+   { "controlPIDBank<32>/PID/condicional",    CasoBanco },
+};
+
+/***************************************************************************************/
+
+static double Medir(FuncionCaso FUNCION, uint64_t ITERACIONES)
+// Devuelve los segundos que tarda FUNCION con ITERACIONES.
+{  auto Inicio = std::chrono::steady_clock::now();
+   FUNCION(ITERACIONES);
+   return std::chrono::duration<double>(std::chrono::steady_clock::now() - Inicio).count();
+}
+
+int main(int argc, char** argv)
+{  const char* Filtro = "";
+   bool Csv = false;
+   for (int i = 1; i < argc; i++) {
+      if (strcmp(argv[i], "--csv") == 0) Csv = true;
+      else Filtro = argv[i];
+   }
+   for (unsigned k = 0; k < MUESTRAS; k++) {
+      Errores[k] = 0.5f * sinf(k * 0.0123f) + 0.01f * ((k * 7919) % 13);
+      ErroresGrandes[k] = 50 + Errores[k];
+   }
+
+   if (Csv) printf("caso,ns_por_llamada,iteraciones\n");
+   else printf("%-60s %12s %14s\n", "caso", "ns/llamada", "iteraciones");
+   for (const casoRendimiento& Caso : CASOS) {
+      if (!strstr(Caso.Nombre, Filtro)) continue;
+      // Busco la cantidad de iteraciones que dure al menos TIEMPO_MINIMO:
+      uint64_t Iteraciones = 1000;
+      double Segundos = Medir(Caso.Funcion, Iteraciones);
+      while (Segundos < TIEMPO_MINIMO) {
+         Iteraciones *= 2;
+         Segundos = Medir(Caso.Funcion, Iteraciones);
+      }
+      std::vector<double> Ns;
+      for (int r = 0; r < REPETICIONES; r++) {
+         Ns.push_back(Medir(Caso.Funcion, Iteraciones) * 1e9 / Iteraciones);
+      }
+      std::sort(Ns.begin(), Ns.end());
+      double Mediana = Ns[REPETICIONES / 2];
+      if (Csv) printf("%s,%.3f,%llu\n", Caso.Nombre, Mediana, (unsigned long long)Iteraciones);
+      else printf("%-60s %12.2f %14llu\n", Caso.Nombre, Mediana, (unsigned long long)Iteraciones);
+   }
+   return 0;
+}
@@ -0,0 +1,245 @@
+/****************************************************************************************
+  reproductor.cpp
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Reproduce en la PC una traza registrada en el equipo (telemetría de
+           ControlPIDTelemetria.h) para investigar incidentes: pasa cada (intervalo,
+           error) por un controlPID con la misma configuración y compara su salida e
+           integral con las registradas.
+           La traza puede ser:
+           - binaria: registros muestraPID seguidos (./decodificador --crudo), o
+           - CSV: la salida de ./decodificador (se reconoce por el encabezado; sus 9
+             cifras significativas reproducen exactamente cada float).
+           El archivo se mapea en memoria (mmap) y se recorre una sola vez: las
+           páginas ya leídas se descartan, de modo que trazas de varios GB no ocupan
+           RAM.
+           La configuración sale de un estadoPID guardado con GuardarEstado() (el mismo
+           blob que se escribe en EEPROM) o de las opciones. Para que la comparación
+           tenga sentido la traza debe empezar en la primera muestra del PID (indicador
+           PRIMERA), con la integral del estado o nula; registros perdidos (saltos de
+           secuencia) y muestras en la banda muerta (no se registran y su intervalo
+           se suma al del registro siguiente) hacen divergir la reproducción desde
+           ese punto.
+           Termina con código 1 si algún registro difiere más que la tolerancia.
+-----------------------------------------------------------------------------------------
+  Uso:
+           ./reproductor TRAZA [opciones]
+           --estado ARCHIVO       estadoPID binario (constantes, límites, opciones e integral)
+           --pid KP TI TD         constantes (Ti, Td en segundos)
+           --salida MIN MAX       limita la salida
+           --integral             limita la integral
+           --condicional          integral condicional
+           --retrocalculo TT      retrocálculo de la integral
+           --filtro N             filtro derivativo
+           --lazo N               sólo los registros de ese lazo (por omisión: el del primero)
+           --tolerancia T         diferencia admitida: T*max(1,|valor|) (por omisión 1e-6)
+           --diferencias          imprime en CSV cada registro que difiere
+****************************************************************************************/
+
+#include "Arduino.h"
+#include "ControlPID.h"
+#include "ControlPIDTelemetria.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/***************************************************************************************/
+
+static const size_t DESCARTE = 64UL << 20;     // Cada cuántos bytes leídos se liberan las páginas
+
+class trazaMapeada                   // Lectura secuencial de un archivo mapeado en memoria
+{  private:
+      const char* Inicio;
+      const char* Fin;
+      const char* Cursor;
+      const char* Liberado;          // Hasta aquí ya se devolvieron las páginas
+      size_t Pagina;
+   public:
+      trazaMapeada() : Inicio(NULL), Fin(NULL), Cursor(NULL), Liberado(NULL), Pagina(4096) {}
+      ~trazaMapeada() { if (Inicio) munmap((void*)Inicio, Fin - Inicio); }
+      bool Abrir(const char* NOMBRE)
+      {  int Archivo = open(NOMBRE, O_RDONLY);
+         if (Archivo < 0) return false;
+         struct stat Datos;
+         if (fstat(Archivo, &Datos) != 0 || Datos.st_size == 0) {
+            close(Archivo);
+            return false;
+         }
+         void* Mapa = mmap(NULL, Datos.st_size, PROT_READ, MAP_PRIVATE, Archivo, 0);
+         close(Archivo);                         // El mapa sigue válido
+         if (Mapa == MAP_FAILED) return false;
+         madvise(Mapa, Datos.st_size, MADV_SEQUENTIAL);
+         Inicio = Cursor = Liberado = (const char*)Mapa;
+         Fin = Inicio + Datos.st_size;
+         Pagina = sysconf(_SC_PAGESIZE);
+         return true;
+      }
+      const char* Actual() const { return Cursor; }
+      const char* Final() const { return Fin; }
+      size_t Restantes() const { return Fin - Cursor; }
+      void Avanzar(size_t BYTES)
+      // Las páginas ya leídas no se vuelven a usar: las suelto cada DESCARTE bytes
+      // (en un mapa de sólo lectura sólo se pierde la caché, no los datos).
+      {  Cursor += BYTES;
+         if ((size_t)(Cursor - Liberado) >= DESCARTE) {
+            const char* Hasta = Inicio + ((Cursor - Inicio) / Pagina) * Pagina;
+            madvise((void*)Liberado, Hasta - Liberado, MADV_DONTNEED);
+            Liberado = Hasta;
+         }
+      }
+};
+
+/***************************************************************************************/
+
+static bool LeerBinario(trazaMapeada& TRAZA, muestraPID& MUESTRA)
+{  if (TRAZA.Restantes() < sizeof(muestraPID)) return false;
+   memcpy(&MUESTRA, TRAZA.Actual(), sizeof(muestraPID));
+   TRAZA.Avanzar(sizeof(muestraPID));
+   return true;
+}
+
+static bool LeerCSV(trazaMapeada& TRAZA, muestraPID& MUESTRA)
+// Una línea de ./decodificador:
+// lazo,secuencia,tiempo_us,error,proporcional,integral,derivativo,salida,saturada,integral_bloqueada
+// (la línea no termina en '\0': copio cada campo antes de convertirlo).
+{  while (TRAZA.Restantes() > 0) {
+      const char* Linea = TRAZA.Actual();
+      const char* FinLinea = (const char*)memchr(Linea, '\n', TRAZA.Restantes());
+      if (!FinLinea) FinLinea = TRAZA.Final();
+      TRAZA.Avanzar(FinLinea - Linea + (FinLinea < TRAZA.Final() ? 1 : 0));
+      double Campos[10];
+      int Cantidad = 0;
+      for (const char* p = Linea; p < FinLinea && Cantidad < 10; ) {
+         const char* Coma = (const char*)memchr(p, ',', FinLinea - p);
+         if (!Coma) Coma = FinLinea;
+         char Texto[64];
+         size_t Largo = (size_t)(Coma - p) < sizeof(Texto) - 1 ? (size_t)(Coma - p) : sizeof(Texto) - 1;
+         memcpy(Texto, p, Largo);
+         Texto[Largo] = 0;
+         char* Resto;
+         Campos[Cantidad] = strtod(Texto, &Resto);
+         if (Resto == Texto) break;              // Encabezado o línea inválida
+         Cantidad++;
+         p = Coma + 1;
+      }
+      if (Cantidad < 10) continue;
+      MUESTRA.Lazo = (uint8_t)Campos[0];
+      MUESTRA.Secuencia = (uint16_t)Campos[1];
+      MUESTRA.Tiempo = (uint32_t)Campos[2];
+      MUESTRA.Error = (float)Campos[3];
+      MUESTRA.Proporcional = (float)Campos[4];
+      MUESTRA.Integral = (float)Campos[5];
+      MUESTRA.Derivativo = (float)Campos[6];
+      MUESTRA.Salida = (float)Campos[7];
+      // El CSV no tiene el indicador PRIMERA.
+      MUESTRA.Indicadores = (Campos[8] ? muestraPID::SATURADA : 0) | (Campos[9] ? muestraPID::INTEGRAL_BLOQUEADA : 0);
+      return true;
+   }
+   return false;
+}
+
+static bool Difiere(float A, float B, double TOLERANCIA)
+{  double Escala = fabs(B) > 1 ? fabs(B) : 1;
+   return fabs((double)A - B) > TOLERANCIA * Escala || (A != A) != (B != B);
+}
+
+/***************************************************************************************/
+
+int main(int argc, char** argv)
+{  if (argc < 2) {
+      fprintf(stderr, "uso: ./reproductor TRAZA [opciones] (ver el encabezado de reproductor.cpp)\n");
+      return 2;
+   }
+   controlPID PID(1, 0, 0);
+   int Lazo = -1;
+   double Tolerancia = 1e-6;
+   bool Diferencias = false;
+   for (int i = 2; i < argc; i++) {
+      const char* A = argv[i];
+      if (strcmp(A, "--estado") == 0 && i + 1 < argc) {
+         estadoPID Estado;
+         FILE* Archivo = fopen(argv[++i], "rb");
+         if (!Archivo || fread(&Estado, sizeof(Estado), 1, Archivo) != 1 || !PID.RestaurarEstado(Estado)) {
+            fprintf(stderr, "%s: no es un estadoPID válido\n", argv[i]);
+            return 2;
+         }
+         fclose(Archivo);
+      } else if (strcmp(A, "--pid") == 0 && i + 3 < argc) {
+         PID.ConfigurarPID(atof(argv[i + 1]), atof(argv[i + 2]), atof(argv[i + 3]));
+         i += 3;
+      } else if (strcmp(A, "--salida") == 0 && i + 2 < argc) {
+         PID.LimitarSalida(true, atof(argv[i + 1]), atof(argv[i + 2]));
+         i += 2;
+      } else if (strcmp(A, "--integral") == 0) PID.LimitarIntegral(true);
+      else if (strcmp(A, "--condicional") == 0) PID.CondicionarIntegral(true);
+      else if (strcmp(A, "--retrocalculo") == 0 && i + 1 < argc) PID.RetrocalcularIntegral(true, atof(argv[++i]));
+      else if (strcmp(A, "--filtro") == 0 && i + 1 < argc) PID.FiltrarDerivativo(atof(argv[++i]));
+      else if (strcmp(A, "--lazo") == 0 && i + 1 < argc) Lazo = atoi(argv[++i]);
+      else if (strcmp(A, "--tolerancia") == 0 && i + 1 < argc) Tolerancia = atof(argv[++i]);
+      else if (strcmp(A, "--diferencias") == 0) Diferencias = true;
+      else {
+         fprintf(stderr, "opción desconocida: %s\n", A);
+         return 2;
+      }
+   }
+
+   trazaMapeada Traza;
+   if (!Traza.Abrir(argv[1])) {
+      perror(argv[1]);
+      return 2;
+   }
+   bool Csv = Traza.Restantes() >= 5 && memcmp(Traza.Actual(), "lazo,", 5) == 0;
+   if (!Csv && Traza.Restantes() % sizeof(muestraPID) != 0) {
+      fprintf(stderr, "%s: el largo no es múltiplo de %zu (registro muestraPID)\n", argv[1], sizeof(muestraPID));
+      return 2;
+   }
+
+   if (Diferencias) printf("registro,secuencia,salida,salida_registrada,integral,integral_registrada\n");
+   unsigned long long Registros = 0, Distintos = 0, Perdidos = 0, PrimeroDistinto = 0;
+   double MaxSalida = 0, MaxIntegral = 0;
+   bool HayAnterior = false;
+   uint32_t TiempoAnterior = 0;
+   bool HaySecuencia = false;
+   uint16_t Esperada = 0;
+   muestraPID M;
+   while (Csv ? LeerCSV(Traza, M) : LeerBinario(Traza, M)) {
+      // La secuencia es de la cola, que pueden compartir varios lazos: los saltos se
+      // cuentan sobre todos los registros.
+      if (HaySecuencia) Perdidos += (uint16_t)(M.Secuencia - Esperada);
+      HaySecuencia = true;
+      Esperada = M.Secuencia + 1;
+      if (Lazo < 0) Lazo = M.Lazo;
+      if (M.Lazo != Lazo) continue;
+      if (!HayAnterior && !Csv && !(M.Indicadores & muestraPID::PRIMERA)) {
+         fprintf(stderr, "aviso: la traza no empieza en la primera muestra del PID\n");
+      }
+      // Tiempo es el del lazo: la diferencia es el intervalo medido de esta muestra (sin
+      // recortar: el PID reproducido aplica su propia política de demora).
+      uint32_t Intervalo = HayAnterior ? M.Tiempo - TiempoAnterior : 0;
+      HayAnterior = true;
+      TiempoAnterior = M.Tiempo;
+
+      PID.ControlarIntervalo(M.Error, Intervalo);
+      float Salida = PID.ObtenerSalida();
+      float Integral = PID.ObtenerIntegral();
+      MaxSalida = fmax(MaxSalida, fabs((double)Salida - M.Salida));
+      MaxIntegral = fmax(MaxIntegral, fabs((double)Integral - M.Integral));
+      if (Difiere(Salida, M.Salida, Tolerancia) || Difiere(Integral, M.Integral, Tolerancia)) {
+         if (Distintos++ == 0) PrimeroDistinto = Registros;
+         if (Diferencias) printf("%llu,%u,%.9g,%.9g,%.9g,%.9g\n", Registros, M.Secuencia,
+                                 Salida, M.Salida, Integral, M.Integral);
+      }
+      Registros++;
+   }
+
+   fprintf(stderr, "%llu registros del lazo %d (%s), %llu perdidos en la cola\n", Registros, Lazo < 0 ? 0 : Lazo,
+           Csv ? "CSV" : "binario", Perdidos);
+   fprintf(stderr, "max|Δsalida| %.3e, max|Δintegral| %.3e\n", MaxSalida, MaxIntegral);
+   if (Distintos) fprintf(stderr, "%llu registros difieren (el primero: %llu)\n", Distintos, PrimeroDistinto);
+   else fprintf(stderr, "la reproducción coincide con la traza\n");
+   return Distintos ? 1 : 0;
+}
@@ -0,0 +1,153 @@
+/****************************************************************************************
+  simulador.cpp
+-----------------------------------------------------------------------------------------
+  Descripción:
+           Barrido de constantes y modos anti-enrole de controlPID sobre una planta
+           simulada (ver Simulacion.h). Cada combinación es un ensayo de escalón de
+           referencia con una perturbación a la mitad del tiempo; los ensayos se
+           reparten entre todos los núcleos. Imprime las mejores combinaciones según
+           el índice elegido (o todas, en CSV, para comparar versiones de la biblioteca:
+           los índices son deterministas, sólo ns/paso depende de la PC).
+-----------------------------------------------------------------------------------------
+  Uso:
+           ./simulador [opciones]
+           --planta primer|segundo|integradora K A B L   (por omisión: primer 2 5 0 1)
+           --kp MIN MAX N, --ti MIN MAX N, --td MIN MAX N   valores del barrido
+                                           (por omisión 0.2-3 x8, 1-12 x8, 0-1 x5)
+           --periodo US      período de muestreo (10000)
+           --duracion S      tiempo simulado por ensayo (120)
+           --hilos N         hilos (0: uno por núcleo)
+           --orden iae|ise|itae   índice para ordenar (iae)
+           --mejores N       cantidad de combinaciones a imprimir (10)
+           --csv             imprime todas las combinaciones en CSV
+****************************************************************************************/
+
+#include "Simulacion.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+/***************************************************************************************/
+
+static const char* const NOMBRES_ANTIENROLE[] = { "ninguno", "limite", "condicional", "retrocalculo" };
+
+struct rangoBarrido { float Min, Max; int N; };
+
+static float Valor(const rangoBarrido& RANGO, int i)
+{  return (RANGO.N > 1) ? RANGO.Min + (RANGO.Max - RANGO.Min) * i / (RANGO.N - 1) : RANGO.Min;
+}
+
+static double Indice(const resultadoPID& R, const char* ORDEN)
+{  if (strcmp(ORDEN, "ise") == 0) return R.ISE;
+   if (strcmp(ORDEN, "itae") == 0) return R.ITAE;
+   return R.IAE;
+}
+
+int main(int argc, char** argv)
+{  modeloPlanta Planta = { TipoPlanta::PrimerOrden, 2, 5, 0, 1 };
+   rangoBarrido Kp = { 0.2f, 3, 8 }, Ti = { 1, 12, 8 }, Td = { 0, 1, 5 };
+   unsigned long Periodo = 10000;
+   double Duracion = 120;
+   unsigned Hilos = 0;
+   const char* Orden = "iae";
+   size_t Mejores = 10;
+   bool Csv = false;
+
+   for (int i = 1; i < argc; i++) {
+      const char* A = argv[i];
+      if (strcmp(A, "--planta") == 0 && i + 5 < argc) {
+         const char* Tipo = argv[++i];
+         Planta.Tipo = (strcmp(Tipo, "segundo") == 0) ? TipoPlanta::SegundoOrden :
+                       (strcmp(Tipo, "integradora") == 0) ? TipoPlanta::Integradora : TipoPlanta::PrimerOrden;
+         Planta.K = atof(argv[++i]);
+         Planta.A = atof(argv[++i]);
+         Planta.B = atof(argv[++i]);
+         Planta.Retardo = atof(argv[++i]);
+      } else if ((strcmp(A, "--kp") == 0 || strcmp(A, "--ti") == 0 || strcmp(A, "--td") == 0) && i + 3 < argc) {
+         rangoBarrido& R = (A[3] == 'p') ? Kp : (A[3] == 'i') ? Ti : Td;
+         R.Min = atof(argv[++i]);
+         R.Max = atof(argv[++i]);
+         R.N = atoi(argv[++i]);
+      } else if (strcmp(A, "--periodo") == 0 && i + 1 < argc) Periodo = strtoul(argv[++i], NULL, 10);
+      else if (strcmp(A, "--duracion") == 0 && i + 1 < argc) Duracion = atof(argv[++i]);
+      else if (strcmp(A, "--hilos") == 0 && i + 1 < argc) Hilos = atoi(argv[++i]);
+      else if (strcmp(A, "--orden") == 0 && i + 1 < argc) Orden = argv[++i];
+      else if (strcmp(A, "--mejores") == 0 && i + 1 < argc) Mejores = atoi(argv[++i]);
+      else if (strcmp(A, "--csv") == 0) Csv = true;
+      else {
+         fprintf(stderr, "Opción desconocida: %s (ver el encabezado de simulador.cpp)\n", A);
+         return 2;
+      }
+   }
+   if (Kp.N < 1 || Ti.N < 1 || Td.N < 1 || Periodo == 0) {
+      fprintf(stderr, "Barrido vacío o período nulo\n");
+      return 2;
+   }
+
+   std::vector<ensayoPID> Ensayos;
+   for (int a = 0; a < 4; a++)
+      for (int i = 0; i < Kp.N; i++)
+         for (int j = 0; j < Ti.N; j++)
+            for (int k = 0; k < Td.N; k++) {
+               ensayoPID E;
+               E.Planta = Planta;
+               E.Kp = Valor(Kp, i);
+               E.Ti = Valor(Ti, j);
+               E.Td = Valor(Td, k);
+               E.FiltroDerivativo = 10;
+               E.AntiEnrole = (AntiEnroleSimulado)a;
+               E.TiempoSeguimiento = sqrtf(E.Ti * (E.Td > 0 ? E.Td : E.Ti));  // Regla usual Tt = sqrt(Ti*Td)
+               E.SalidaMin = 0;
+               E.SalidaMax = 100;
+               E.Referencia = 40;
+               E.Perturbacion = -10;
+               E.TiempoPerturbacion = Duracion / 2;
+               E.Duracion = Duracion;
+               E.Periodo = Periodo;
+               Ensayos.push_back(E);
+            }
+   std::vector<resultadoPID> Resultados(Ensayos.size());
+
+   auto Inicio = std::chrono::steady_clock::now();
+   SimularEnParalelo(Ensayos.data(), Resultados.data(), Ensayos.size(), Hilos);
+   double Segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - Inicio).count();
+
+   std::vector<size_t> Orden_(Ensayos.size());
+   for (size_t i = 0; i < Orden_.size(); i++) Orden_[i] = i;
+   std::stable_sort(Orden_.begin(), Orden_.end(), [&](size_t A, size_t B) {
+      return Indice(Resultados[A], Orden) < Indice(Resultados[B], Orden);
+   });
+
+   if (Csv) {
+      printf("kp,ti,td,antienrole,iae,ise,itae,sobrepico,establecimiento,ns_paso\n");
+      for (size_t i : Orden_) {
+         const ensayoPID& E = Ensayos[i];
+         const resultadoPID& R = Resultados[i];
+         printf("%g,%g,%g,%s,%.6g,%.6g,%.6g,%.3f,%.3f,%.2f\n", E.Kp, E.Ti, E.Td,
+                NOMBRES_ANTIENROLE[(int)E.AntiEnrole], R.IAE, R.ISE, R.ITAE,
+                R.Sobrepico, R.Establecimiento, R.NsPorPaso);
+      }
+      return 0;
+   }
+   unsigned long long Pasos = 0;
+   double Ns = 0;
+   for (const resultadoPID& R : Resultados) {
+      Pasos += R.Pasos;
+      Ns += R.NsPorPaso * R.Pasos;
+   }
+   printf("%zu ensayos, %llu pasos en %.2f s (%.1f ns/paso en cada hilo)\n\n",
+          Ensayos.size(), Pasos, Segundos, Pasos ? Ns / Pasos : 0);
+   printf("%7s %7s %7s %-13s %10s %10s %10s %9s %9s %8s\n", "kp", "ti", "td", "antienrole",
+          "iae", "ise", "itae", "sobrep%", "estab_s", "ns/paso");
+   for (size_t n = 0; n < Mejores && n < Orden_.size(); n++) {
+      const ensayoPID& E = Ensayos[Orden_[n]];
+      const resultadoPID& R = Resultados[Orden_[n]];
+      printf("%7.3f %7.3f %7.3f %-13s %10.4g %10.4g %10.4g %9.2f %9.2f %8.2f\n", E.Kp, E.Ti, E.Td,
+             NOMBRES_ANTIENROLE[(int)E.AntiEnrole], R.IAE, R.ISE, R.ITAE,
+             R.Sobrepico, R.Establecimiento, R.NsPorPaso);
+   }
+   return 0;
+}